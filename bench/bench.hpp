@@ -0,0 +1,67 @@
+#pragma once
+
+// global includes
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+/* minimal benchmark helpers
+    shared by all benchmark targets in bench/
+*/
+namespace bench {
+
+// keep value alive, forcing the compiler to materialize it
+template < class T >
+inline void do_not_optimize( const T& value ) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    const volatile void* sink = &value;
+    (void)sink;
+#else
+    __asm__ __volatile__("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// assume all memory was read and written
+inline void clobber() {
+#if !defined(_MSC_VER) || defined(__clang__)
+    __asm__ __volatile__("" : : : "memory");
+#endif
+}
+
+/* measure
+    returns the best ns/op of several repetitions. The iteration count of a
+    repetition is scaled until it runs for at least min_ms milliseconds.
+*/
+template < class Fn >
+double measure( Fn&& fn, double min_ms = 20.0, int repetitions = 5 ) {
+    typedef std::chrono::steady_clock clock;
+    size_t iterations = 1;
+    for ( ;; ) {
+        const auto start = clock::now();
+        for ( size_t i = 0; iterations > i; ++i ) {
+            fn();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        if ( ms >= min_ms )
+            break;
+        iterations *= ( ms < min_ms / 10.0 ) ? 10 : 2;
+    }
+
+    double best = 0.0;
+    for ( int r = 0; repetitions > r; ++r ) {
+        const auto start = clock::now();
+        for ( size_t i = 0; iterations > i; ++i ) {
+            fn();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+        best = ( r == 0 ) ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+// bytes per nanosecond equal GB/s
+inline double gbps( size_t bytes, double ns ) {
+    return ns > 0.0 ? static_cast<double>(bytes) / ns : 0.0;
+}
+
+}
@@ -0,0 +1,246 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/resource.h>
+#   include <sys/stat.h>
+#   include <sys/types.h>
+#   include <sys/wait.h>
+#   include <unistd.h>
+#endif
+#if defined(__linux__)
+#   include <elf.h>
+#endif
+
+/* compile-time cost of cs::crypt
+    generates translation units with many crypted strings of varying lengths and
+    compiles each with every given compiler. Reports compile wall time, peak
+    compiler RSS, object size and the size of all executable sections.
+
+    --sites functor crypts every string with one shared xor_functor (default),
+    --sites macro uses CS_CRYPT, which derives a distinct key for every call site.
+
+    usage: compile_bench [--compiler CXX]... [--counts N,N,...] [--define MACRO]...
+                         [--sites functor|macro] [--include DIR] [--dir DIR] [--json]
+*/
+
+struct options {
+    std::vector<std::string> compilers;
+    std::vector<size_t> counts;
+    std::vector<std::string> defines;
+    std::string sites = "functor";
+    std::string include = "../src";
+    std::string dir = "compile_bench.tmp";
+    bool json = false;
+};
+
+struct result {
+    std::string compiler;
+    std::string defines;
+    std::string sites;
+    size_t strings;
+    bool ok;
+    double wall_s;
+    long peak_rss_kb;
+    long long object_bytes;
+    long long text_bytes;
+};
+
+// deterministic xorshift, so every run generates the same corpus
+struct rng {
+    uint64_t state;
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// one function per string, like a call site in a real code base
+static void generate( const std::string& path, size_t count, bool macro ) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 ";
+    rng r = { 0x9e3779b97f4a7c15ull };
+
+    std::ofstream out(path);
+    out << "#define CS_BUILD_SEED 0x1337\n";
+    out << "#include <cryptstr.hpp>\n\n";
+    if ( !macro )
+        out << "static constexpr cs::xor_functor<0x1337> functor;\n\n";
+    for ( size_t i = 0; count > i; ++i ) {
+        const size_t length = 4 + r.next() % 125;
+        std::string text(length, ' ');
+        for ( size_t c = 0; length > c; ++c ) {
+            text[c] = alphabet[r.next() % (sizeof(alphabet) - 1)];
+        }
+        out << "size_t site_" << i << "(char* buffer) {\n"
+            << "    static constexpr auto crypted = "
+            << ( macro ? "CS_CRYPT(\"" : "cs::crypt(functor, \"" ) << text << "\");\n"
+            << "    return crypted.decrypt_into(buffer, 256);\n"
+            << "}\n";
+    }
+}
+
+static long long file_size( const std::string& path ) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in ? static_cast<long long>(in.tellg()) : -1;
+}
+
+// sum of all executable sections, including the per-function COMDAT sections
+static long long text_size( const std::string& path ) {
+#if defined(__linux__)
+    std::ifstream in(path, std::ios::binary);
+    Elf64_Ehdr header;
+    if ( !in.read(reinterpret_cast<char*>(&header), sizeof(header)) )
+        return -1;
+    if ( std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64 )
+        return -1;
+    long long total = 0;
+    for ( unsigned i = 0; header.e_shnum > i; ++i ) {
+        Elf64_Shdr section;
+        in.seekg(static_cast<std::streamoff>(header.e_shoff + i * header.e_shentsize));
+        if ( !in.read(reinterpret_cast<char*>(&section), sizeof(section)) )
+            return -1;
+        if ( section.sh_flags & SHF_EXECINSTR )
+            total += static_cast<long long>(section.sh_size);
+    }
+    return total;
+#else
+    (void)path;
+    return -1;
+#endif
+}
+
+static result compile( const options& opt, const std::string& compiler, const std::string& source, size_t count ) {
+    result res = { compiler, "", opt.sites, count, false, 0.0, -1, -1, -1 };
+    for ( const std::string& define : opt.defines ) {
+        res.defines += ( res.defines.empty() ? "" : " " ) + define;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    const std::string object = source + ".o";
+    std::vector<std::string> args = { compiler, "-std=c++17", "-O2", "-I" + opt.include };
+    for ( const std::string& define : opt.defines ) {
+        args.push_back("-D" + define);
+    }
+    args.insert(args.end(), { "-c", source, "-o", object });
+
+    std::vector<char*> argv;
+    for ( std::string& arg : args ) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    std::remove(object.c_str());
+    const auto start = std::chrono::steady_clock::now();
+    const pid_t pid = fork();
+    if ( pid == 0 ) {
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    if ( pid < 0 )
+        return res;
+
+    int status = 0;
+    struct rusage usage;
+    if ( wait4(pid, &status, 0, &usage) != pid )
+        return res;
+    res.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#if defined(__APPLE__)
+    res.peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+    res.peak_rss_kb = usage.ru_maxrss;
+#endif
+    res.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if ( res.ok ) {
+        res.object_bytes = file_size(object);
+        res.text_bytes = text_size(object);
+    }
+#else
+    (void)opt; (void)source;
+#endif
+    return res;
+}
+
+static std::vector<size_t> parse_counts( const char* list ) {
+    std::vector<size_t> counts;
+    for ( const char* p = list; *p; ) {
+        char* end = nullptr;
+        counts.push_back(std::strtoull(p, &end, 10));
+        p = ( *end == ',' ) ? end + 1 : end;
+        if ( end == p && *p )
+            break;
+    }
+    return counts;
+}
+
+int main(int argc, char *argv[]) {
+    options opt;
+    for ( int i = 1; argc > i; ++i ) {
+        const bool has_value = argc > i + 1;
+        if ( std::strcmp(argv[i], "--compiler") == 0 && has_value ) {
+            opt.compilers.push_back(argv[++i]);
+        } else if ( std::strcmp(argv[i], "--counts") == 0 && has_value ) {
+            opt.counts = parse_counts(argv[++i]);
+        } else if ( std::strcmp(argv[i], "--define") == 0 && has_value ) {
+            opt.defines.push_back(argv[++i]);
+        } else if ( std::strcmp(argv[i], "--sites") == 0 && has_value ) {
+            opt.sites = argv[++i];
+        } else if ( std::strcmp(argv[i], "--include") == 0 && has_value ) {
+            opt.include = argv[++i];
+        } else if ( std::strcmp(argv[i], "--dir") == 0 && has_value ) {
+            opt.dir = argv[++i];
+        } else if ( std::strcmp(argv[i], "--json") == 0 ) {
+            opt.json = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [--compiler CXX]... [--counts N,N,...] [--define MACRO]... "
+                                 "[--sites functor|macro] [--include DIR] [--dir DIR] [--json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if ( opt.compilers.empty() )
+        opt.compilers = { "g++", "clang++" };
+    if ( opt.counts.empty() )
+        opt.counts = { 1000, 10000, 50000 };
+
+#if !defined(__unix__) && !defined(__APPLE__)
+    std::fprintf(stderr, "compile_bench requires a POSIX system\n");
+    return 1;
+#else
+    mkdir(opt.dir.c_str(), 0755);
+
+    std::vector<result> results;
+    for ( size_t count : opt.counts ) {
+        const std::string source = opt.dir + "/strings_" + std::to_string(count) + ".cpp";
+        generate(source, count, opt.sites == "macro");
+        for ( const std::string& compiler : opt.compilers ) {
+            results.push_back(compile(opt, compiler, source, count));
+            if ( !opt.json ) {
+                const result& r = results.back();
+                std::printf("%-10s %-8s %8zu strings %s %9.2f s %9ld KiB rss %11lld B obj %11lld B text %s\n",
+                            r.compiler.c_str(), r.sites.c_str(), r.strings, r.ok ? "ok    " : "failed",
+                            r.wall_s, r.peak_rss_kb, r.object_bytes, r.text_bytes, r.defines.c_str());
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    if ( opt.json ) {
+        std::printf("{\n  \"benchmark\": \"compile\",\n  \"results\": [\n");
+        for ( size_t i = 0; results.size() > i; ++i ) {
+            const result& r = results[i];
+            std::printf("    {\"compiler\": \"%s\", \"sites\": \"%s\", \"defines\": \"%s\", \"strings\": %zu, \"ok\": %s, \"wall_s\": %.3f, "
+                        "\"peak_rss_kb\": %ld, \"object_bytes\": %lld, \"text_bytes\": %lld}%s\n",
+                        r.compiler.c_str(), r.sites.c_str(), r.defines.c_str(), r.strings, r.ok ? "true" : "false", r.wall_s,
+                        r.peak_rss_kb, r.object_bytes, r.text_bytes, ( i + 1 < results.size() ) ? "," : "");
+        }
+        std::printf("  ]\n}\n");
+    }
+    return 0;
+#endif
+}
@@ -0,0 +1,12 @@
+# conf
+CONFIG -= qt
+CONFIG += c++17 release
+
+# inputs
+SOURCES += \
+        compile_bench.cpp
+
+# outputs
+DESTDIR = .
+OBJECTS_DIR = obj/
+TARGET = compile_bench
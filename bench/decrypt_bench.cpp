@@ -0,0 +1,186 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+#include <utility>
+#include <cryptstr.hpp>
+#include <cryptstr_arena.hpp>
+#include "bench.hpp"
+
+/* decrypt throughput and wipe latency
+    measures per string length, functor type and char type:
+        decrypt_into        cryptstr::decrypt_into into a preallocated buffer
+        wipe                cs::memzero of the decrypted bytes
+        strview             cryptstr::decrypt followed by ~strview
+        static_strview      cryptstr::decrypt_static followed by ~static_strview
+        arena               cs::decrypt into a secure_arena followed by secure_arena::reset
+    and for a startup-like set of 256 keys of 32 chars, each with its own xorshift_keystream seed:
+        keys_strview        cryptstr::decrypt followed by ~strview for every key
+        keys_batch          cs::decrypt_batch of all keys followed by secure_arena::reset
+
+    usage: decrypt_bench [--json] [--quick]
+*/
+
+// position dependent functor without block protocol, measures the per-element path
+struct index_xor_functor {
+    template < class CharType >
+    constexpr CharType operator () ( const CharType* str, size_t len, size_t index ) noexcept {
+        (void)len;
+        return static_cast<CharType>(str[index] ^ static_cast<CharType>(0x5a + index));
+    }
+};
+
+template < class T > struct type_name;
+template <> struct type_name<char> { static constexpr const char* value = "char"; };
+template <> struct type_name<char16_t> { static constexpr const char* value = "char16_t"; };
+template <> struct type_name<char32_t> { static constexpr const char* value = "char32_t"; };
+template <> struct type_name<cs::xor_functor<0x1337>> { static constexpr const char* value = "xor"; };
+template <> struct type_name<index_xor_functor> { static constexpr const char* value = "index_xor"; };
+template <> struct type_name<cs::xorshift_functor<0x1337>> { static constexpr const char* value = "xorshift"; };
+template <> struct type_name<cs::pcg_functor<0x1337>> { static constexpr const char* value = "pcg"; };
+template <> struct type_name<cs::chacha_functor<0x1337>> { static constexpr const char* value = "chacha8"; };
+
+struct result {
+    std::string op;
+    const char* functor;
+    const char* char_type;
+    size_t length;
+    size_t bytes;
+    double ns;
+};
+
+struct options {
+    bool json = false;
+    double min_ms = 20.0;
+};
+
+// printable payload of N-1 characters and a terminator
+template < class CharType, size_t N >
+constexpr cs::ctstr<CharType,N> payload() {
+    CharType values[N] = {};
+    for ( size_t i = 0; N - 1 > i; ++i ) {
+        values[i] = static_cast<CharType>('A' + i % 58);
+    }
+    return cs::make_ctstr(values);
+}
+
+template < class CharType, class Functor, size_t N >
+void run_length( const options& opt, std::vector<result>& results ) {
+    static constexpr auto crypted = cs::crypt(Functor(), payload<CharType,N>());
+    const size_t bytes = N * sizeof(CharType);
+    std::vector<CharType> buffer(N);
+    CharType* dst = buffer.data();
+
+    auto add = [&]( const char* op, double ns ) {
+        results.push_back(result{ op, type_name<Functor>::value, type_name<CharType>::value, N, bytes, ns });
+    };
+
+    add("decrypt_into", bench::measure([&] {
+        crypted.decrypt_into(dst, N);
+        bench::clobber();
+    }, opt.min_ms));
+    add("wipe", bench::measure([&] {
+        cs::memzero(dst, bytes);
+        bench::clobber();
+    }, opt.min_ms));
+    add("strview", bench::measure([&] {
+        const auto view = crypted.decrypt();
+        bench::do_not_optimize(view.data());
+    }, opt.min_ms));
+    add("static_strview", bench::measure([&] {
+        const auto view = crypted.decrypt_static();
+        bench::do_not_optimize(view.data());
+    }, opt.min_ms));
+    cs::secure_arena arena(bytes + sizeof(CharType) + cs::secure_arena::alignment);
+    add("arena", bench::measure([&] {
+        const auto view = cs::decrypt(crypted, arena);
+        bench::do_not_optimize(view.data());
+        arena.reset();
+    }, opt.min_ms));
+}
+
+// keys of one functor type with distinct runtime seeds, like CS_CRYPT sites
+template < size_t... I >
+constexpr auto make_keys( std::index_sequence<I...> ) {
+    return std::array<cs::cryptstr<char,32,cs::xorshift_keystream>, sizeof...(I)>{
+        cs::crypt(cs::xorshift_keystream(0x1337 + I), payload<char,32>())... };
+}
+
+template < size_t... I >
+void run_keys( const options& opt, std::vector<result>& results, std::index_sequence<I...> seq ) {
+    static constexpr auto keys = make_keys(seq);
+    const size_t bytes = sizeof...(I) * 32;
+
+    results.push_back(result{ "keys_strview", "xorshift", "char", 32, bytes, bench::measure([&] {
+        for ( const auto& key : keys ) {
+            const auto view = key.decrypt();
+            bench::do_not_optimize(view.data());
+        }
+    }, opt.min_ms) });
+    cs::secure_arena arena(bytes + sizeof...(I) + cs::secure_arena::alignment);
+    results.push_back(result{ "keys_batch", "xorshift", "char", 32, bytes, bench::measure([&] {
+        const auto views = cs::decrypt_batch(arena, keys[I]...);
+        bench::do_not_optimize(views.data());
+        arena.reset();
+    }, opt.min_ms) });
+}
+
+template < class CharType, class Functor, size_t... Lengths >
+void run_lengths( const options& opt, std::vector<result>& results, std::index_sequence<Lengths...> ) {
+    (run_length<CharType,Functor,Lengths>(opt, results), ...);
+}
+
+template < class CharType, class Functor >
+void run( const options& opt, std::vector<result>& results ) {
+    run_lengths<CharType,Functor>(opt, results, std::index_sequence<16, 64, 256, 1024, 4096, 16384>());
+}
+
+template < class CharType >
+void run_functors( const options& opt, std::vector<result>& results ) {
+    run<CharType, cs::xor_functor<0x1337>>(opt, results);
+    run<CharType, index_xor_functor>(opt, results);
+    run<CharType, cs::xorshift_functor<0x1337>>(opt, results);
+    run<CharType, cs::pcg_functor<0x1337>>(opt, results);
+    run<CharType, cs::chacha_functor<0x1337>>(opt, results);
+}
+
+int main(int argc, char *argv[]) {
+    options opt;
+    for ( int i = 1; argc > i; ++i ) {
+        if ( std::strcmp(argv[i], "--json") == 0 ) {
+            opt.json = true;
+        } else if ( std::strcmp(argv[i], "--quick") == 0 ) {
+            opt.min_ms = 2.0;
+        } else {
+            std::fprintf(stderr, "usage: %s [--json] [--quick]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<result> results;
+    run_functors<char>(opt, results);
+    run_functors<char16_t>(opt, results);
+    run_functors<char32_t>(opt, results);
+    run_keys(opt, results, std::make_index_sequence<256>());
+
+    if ( opt.json ) {
+        std::printf("{\n  \"benchmark\": \"decrypt\",\n  \"wipe_backend\": \"%s\",\n  \"results\": [\n", cs::wipe_backend());
+        for ( size_t i = 0; results.size() > i; ++i ) {
+            const result& r = results[i];
+            std::printf("    {\"op\": \"%s\", \"functor\": \"%s\", \"char_type\": \"%s\", \"length\": %zu, "
+                        "\"bytes\": %zu, \"ns_per_op\": %.3f, \"gb_per_s\": %.3f}%s\n",
+                        r.op.c_str(), r.functor, r.char_type, r.length, r.bytes, r.ns,
+                        bench::gbps(r.bytes, r.ns), ( i + 1 < results.size() ) ? "," : "");
+        }
+        std::printf("  ]\n}\n");
+    } else {
+        std::printf("%-16s %-10s %-9s %8s %12s %10s\n", "op", "functor", "char", "length", "ns/op", "GB/s");
+        for ( const result& r : results ) {
+            std::printf("%-16s %-10s %-9s %8zu %12.1f %10.2f\n",
+                        r.op.c_str(), r.functor, r.char_type, r.length, r.ns, bench::gbps(r.bytes, r.ns));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,18 @@
+# conf
+CONFIG -= qt
+CONFIG += c++17 release
+
+# inputs
+HEADERS += \
+    bench.hpp \
+    ../src/cryptstr.hpp \
+    ../src/cryptstr_arena.hpp
+SOURCES += \
+        decrypt_bench.cpp
+
+INCLUDEPATH += ../src/
+
+# outputs
+DESTDIR = .
+OBJECTS_DIR = obj/
+TARGET = decrypt_bench
@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <cryptstr.hpp>
+#include <cryptstr_blob.hpp>
+#include <cryptstr_parallel.hpp>
+#include "bench.hpp"
+
+/* parallel decrypt scaling
+    decrypts a blob of --mib MiB (default 16) with cs::decrypt_parallel on 1 to --threads threads
+    (default std::thread::hardware_concurrency()), for the xorshift, pcg and chacha8 keystreams.
+    The blob is encrypted at runtime, like tools/embed does at build time.
+
+    usage: parallel_bench [--mib N] [--threads N]
+*/
+
+template < class Keystream >
+void run( const char* name, size_t bytes, unsigned max_threads ) {
+    const Keystream functor(0x1337);
+    std::vector<unsigned char> plain(bytes);
+    for ( size_t i = 0; bytes > i; ++i ) {
+        plain[i] = static_cast<unsigned char>(i * 131);
+    }
+    std::vector<unsigned char> storage(bytes + 64);
+    unsigned char* crypted = storage.data() + ((64 - (reinterpret_cast<uintptr_t>(storage.data()) & 63)) & 63);
+    functor.apply_block(plain.data(), crypted, 0, bytes);
+    const cs::cryptblob<Keystream> blob(functor, crypted, bytes);
+
+    std::vector<unsigned char> output(bytes + 64);
+    unsigned char* dst = output.data() + ((64 - (reinterpret_cast<uintptr_t>(output.data()) & 63)) & 63);
+
+    double single_ns = 0.0;
+    for ( unsigned threads = 1; max_threads >= threads; threads *= 2 ) {
+        const double ns = bench::measure([&] {
+            cs::decrypt_parallel(blob, dst, bytes, threads);
+            bench::clobber();
+        }, 200.0, 3);
+        if ( threads == 1 )
+            single_ns = ns;
+        std::printf("%-10s %8u %12.3f %10.2f %8.2fx\n", name, threads, ns / 1e6, bench::gbps(bytes, ns), single_ns / ns);
+        if ( threads < max_threads && threads * 2 > max_threads )
+            threads = max_threads / 2;
+    }
+    if ( std::memcmp(dst, plain.data(), bytes) != 0 ) {
+        std::fprintf(stderr, "%s: decrypted data does not match\n", name);
+        std::exit(1);
+    }
+    cs::memzero(dst, bytes);
+}
+
+int main(int argc, char *argv[]) {
+    size_t mib = 16;
+    unsigned max_threads = std::thread::hardware_concurrency();
+    for ( int i = 1; argc > i; ++i ) {
+        if ( std::strcmp(argv[i], "--mib") == 0 && argc > i + 1 ) {
+            mib = std::strtoul(argv[++i], nullptr, 10);
+        } else if ( std::strcmp(argv[i], "--threads") == 0 && argc > i + 1 ) {
+            max_threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::fprintf(stderr, "usage: %s [--mib N] [--threads N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if ( max_threads == 0 )
+        max_threads = 1;
+
+    const size_t bytes = mib << 20;
+    std::printf("%zu MiB, chunk %d bytes\n", mib, CS_PARALLEL_CHUNK);
+    std::printf("%-10s %8s %12s %10s %9s\n", "functor", "threads", "ms", "GB/s", "speedup");
+    run<cs::xorshift_keystream>("xorshift", bytes, max_threads);
+    run<cs::pcg_keystream>("pcg", bytes, max_threads);
+    run<cs::chacha_keystream>("chacha8", bytes, max_threads);
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+# conf
+CONFIG -= qt
+CONFIG += c++17 release thread
+
+# inputs
+HEADERS += \
+    bench.hpp \
+    ../src/cryptstr.hpp \
+    ../src/cryptstr_blob.hpp \
+    ../src/cryptstr_parallel.hpp
+SOURCES += \
+        parallel_bench.cpp
+
+INCLUDEPATH += ../src/
+
+# outputs
+DESTDIR = .
+OBJECTS_DIR = obj/
+TARGET = parallel_bench
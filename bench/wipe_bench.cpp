@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <cryptstr.hpp>
+#include "bench.hpp"
+
+/* wipe backends
+    measures every wipe backend available in this build in one run, 16 B to 1 MiB: the byte-wise
+    volatile loop, the word/SIMD fill engine and the platform primitive (explicit_bzero, memset_s or
+    SecureZeroMemory) if there is one, independent of the backend CS_WIPE_BACKEND selects for cs::memzero.
+    Speedups are relative to the volatile loop.
+*/
+
+struct backend {
+    const char* name;
+    void (*wipe)( void*, size_t );
+};
+
+int main(int argc, char *argv[]) {
+    (void)argc; (void)argv;
+
+    std::vector<backend> backends;
+    backends.push_back({"volatile", [](void* ptr, size_t num) { cs::volatile_memzero(ptr, num); }});
+    backends.push_back({"engine", [](void* ptr, size_t num) { cs::detail::engine_memzero(ptr, num); }});
+#if CS_WIPE_PLATFORM == CS_WIPE_EXPLICIT_BZERO
+    backends.push_back({"explicit_bzero", [](void* ptr, size_t num) { cs::detail::platform_memzero(ptr, num); }});
+#elif CS_WIPE_PLATFORM == CS_WIPE_MEMSET_S
+    backends.push_back({"memset_s", [](void* ptr, size_t num) { cs::detail::platform_memzero(ptr, num); }});
+#elif CS_WIPE_PLATFORM == CS_WIPE_SECUREZERO
+    backends.push_back({"SecureZeroMemory", [](void* ptr, size_t num) { cs::detail::platform_memzero(ptr, num); }});
+#endif
+
+    const size_t max_size = size_t(1) << 20;
+    std::vector<unsigned char> storage(max_size + 64);
+    unsigned char* buffer = storage.data();
+    buffer += (64 - (reinterpret_cast<uintptr_t>(buffer) & 63)) & 63;
+
+    const cs::detail::cpu_features& cpu = cs::detail::cpu();
+    std::printf("cpu: avx2=%d avx512f=%d, memzero backend: %s\n",
+                cpu.avx2 ? 1 : 0, cpu.avx512f ? 1 : 0, cs::wipe_backend());
+    std::printf("%-16s %10s %14s %10s %9s\n", "backend", "bytes", "ns", "GB/s", "speedup");
+
+    for ( size_t size = 16; max_size >= size; size *= 4 ) {
+        double volatile_ns = 0.0;
+        for ( size_t i = 0; backends.size() > i; ++i ) {
+            const backend& current = backends[i];
+            const double ns = bench::measure([&] {
+                current.wipe(buffer, size);
+                bench::clobber();
+            });
+            if ( i == 0 )
+                volatile_ns = ns;
+            std::printf("%-16s %10zu %14.1f %10.2f %8.1fx\n",
+                        current.name, size, ns, bench::gbps(size, ns), volatile_ns / ns);
+        }
+    }
+
+    return 0;
+}
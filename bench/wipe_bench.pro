@@ -0,0 +1,17 @@
+# conf
+CONFIG -= qt
+CONFIG += c++17 release
+
+# inputs
+HEADERS += \
+    bench.hpp \
+    ../src/cryptstr.hpp
+SOURCES += \
+        wipe_bench.cpp
+
+INCLUDEPATH += ../src/
+
+# outputs
+DESTDIR = .
+OBJECTS_DIR = obj/
+TARGET = wipe_bench
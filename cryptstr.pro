@@ -4,7 +4,15 @@ CONFIG += c++17
 
 # inputs
 HEADERS += \
-    src/cryptstr.hpp
+    src/cryptstr.hpp \
+    src/cryptstr_cached.hpp \
+    src/cryptstr_dispatch.hpp \
+    src/cryptstr_table.hpp \
+    src/cryptstr_blob.hpp \
+    src/cryptstr_arena.hpp \
+    src/cryptstr_pagepool.hpp \
+    src/cryptstr_parallel.hpp \
+    src/cryptstr_async.hpp
 SOURCES += \
         main.cpp
 
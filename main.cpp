@@ -24,6 +24,35 @@ int main(int argc, char *argv[]) {
     std::cout << dec1 << std::endl;
     std::cout << dec2 << std::endl;
 
+    // decrypt_into() writes the de-obfuscated string straight into caller memory without any allocation.
+    // the caller is responsible for wiping the buffer afterwards.
+    char buffer[crypted1.size()];
+    crypted1.decrypt_into(buffer);
+    std::cout << buffer << std::endl;
+    cs::memzero(buffer, sizeof(buffer));
+
+    // decrypt_static() returns a static_strview, which holds all characters in an inline array and never
+    // touches the heap. it converts to std::string_view and is wiped on destruction like strview.
+    const auto dec3 = crypted2.decrypt_static();
+    std::cout << dec3 << std::endl;
+
+    // CS_CRYPT() derives a distinct key for every call site from __FILE__, __LINE__, __COUNTER__ and CS_BUILD_SEED.
+    // all call sites share one functor type that holds the key as a value, so they also share the decrypt code.
+    constexpr auto crypted3 = CS_CRYPT("THIRD CRYPTED STRING");
+    std::cout << crypted3.decrypt() << std::endl;
+
+    // decrypt_to() streams a string chunk by chunk into a std::ostream, FILE*, cs::fd_sink or callable, without the
+    // terminating null element. only a small stack buffer, wiped afterwards, ever holds plaintext.
+    crypted1.decrypt_to(std::cout);
+    std::cout << std::endl;
+
+    // decrypt_range() decrypts only part of a string. cursor() returns a crypt_cursor, which decrypts lazily
+    // while it is read and only ever holds a small, wiped window of plaintext.
+    auto cursor = crypted2.cursor();
+    while ( !cursor.eof() && cursor.peek() != ' ' )
+        std::cout << cursor.next();
+    std::cout << std::endl;
+
     // cryptstr instances hold data in a ctstr, which is a compile-time container
     // for strings. ctstr supports various range-checking methods and accessors.
     // you can compare strings during compile time.
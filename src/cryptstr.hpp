@@ -1,9 +1,48 @@
 #pragma once
 
+// request memset_s from C11 Annex K implementations
+#ifndef __STDC_WANT_LIB_EXT1__
+#   define __STDC_WANT_LIB_EXT1__ 1
+#endif
+
 // global includes
 #include <utility>
+#include <type_traits>
 #include <string>
+#include <vector>
+#include <memory>
+#include <string_view>
+#include <iosfwd>
 #include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <unistd.h>
+#elif defined(_WIN32)
+#   include <io.h>
+#endif
+
+#if defined(CS_ENABLE_STATS)
+#   include <atomic>
+#   include <chrono>
+#   include <new>
+#endif
+
+#if defined(CS_PROFILE)
+#   include <algorithm>
+#   include <atomic>
+#   include <chrono>
+#endif
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#   if __has_include(<span>)
+#       include <span>
+#   endif
+#endif
 
 // simple predefs
 namespace predef {
@@ -81,19 +120,227 @@ static_assert( CS_COMPILER != predef::compiler_t::none, "invalid compiler");
 
 #define CS_INLINE
 
+/* identify architectures */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   define CS_X86
+#endif
+
+/* identify byte order, keystream functors use byte-wise kernels on little-endian targets */
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+#   define CS_LITTLE_ENDIAN
+#endif
+
+/* SIMD kernels are available on x86 unless CS_NO_SIMD is defined */
+#if defined(CS_X86) && !defined(CS_NO_SIMD)
+#   define CS_SIMD
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define CS_SSE2
+#   endif
+#endif
+
+#if defined(CS_MSVC)
+#   include <intrin.h>
+#endif
+#if defined(CS_SIMD)
+#   include <immintrin.h>
+#endif
+
+/**
+    CS_BARRIER
+
+    Stores to wiped memory are only guaranteed if the compiler has to assume that the memory
+    is read afterwards. CS_BARRIER(ptr) hands ptr to an empty asm statement with a memory clobber,
+    so all preceding stores through ptr have to be emitted, while the store loop itself can be
+    fully optimized and vectorized.
+
+    Support for: GCC, CLANG, MSVC and all compatible compilers
+*/
+#if defined(CS_CLANG) || defined(CS_GCC)
+#   define CS_BARRIER(ptr) __asm__ __volatile__("" : : "r"(ptr) : "memory")
+#elif defined(CS_MSVC)
+#   define CS_BARRIER(ptr) ((void)(ptr), _ReadWriteBarrier())
+#endif
+
+/* function attributes for runtime dispatched SIMD kernels
+    MSVC does not need them, intrinsics are always available there
+*/
+#if defined(CS_SIMD) && (defined(CS_CLANG) || defined(CS_GCC))
+#   define CS_TARGET_AVX2 __attribute__((target("avx2")))
+#   define CS_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#   define CS_TARGET_AVX2
+#   define CS_TARGET_AVX512
+#endif
+
+
+/* CS_NOINLINE
+    keeps the compiler from inlining a function into its callers
+*/
+#if defined(CS_CLANG) || defined(CS_GCC)
+#   define CS_NOINLINE __attribute__((noinline))
+#elif defined(CS_MSVC)
+#   define CS_NOINLINE __declspec(noinline)
+#endif
+
+/* CS_CONSTEVAL
+    consteval with C++20, so routines that handle plaintext can only run during constant evaluation.
+    Falls back to constexpr, where callers have to use the result in a constexpr variable.
+*/
+#if defined(__cpp_consteval)
+#   define CS_CONSTEVAL consteval
+#else
+#   define CS_CONSTEVAL constexpr
+#endif
+
+/**
+    CS_SHARED_KERNEL
+
+    cryptstr<CharType,N,Functor> is a distinct type for every string length N, and so is its decryption
+    routine. By default that routine is inlined and specialized for N at every call site, which is
+    fastest for few strings but grows .text with every string.
+
+    With CS_SHARED_KERNEL defined, cryptstr only forwards (pointer, N) to a single out-of-line
+    detail::decrypt_kernel per char and functor type, shared by all strings of all lengths.
+*/
+
+/**
+    CS_WIPE_BACKEND
+
+    Selects the primitive behind cs::memzero, zero<T> and zero_plugin_allocator.
+
+        CS_WIPE_VOLATILE        byte-wise volatile loop (cs::volatile_memzero)
+        CS_WIPE_ENGINE          word/SIMD fill engine followed by CS_BARRIER
+        CS_WIPE_EXPLICIT_BZERO  explicit_bzero (glibc >= 2.25, OpenBSD, FreeBSD)
+        CS_WIPE_MEMSET_S        memset_s (C11 Annex K, macOS)
+        CS_WIPE_SECUREZERO      SecureZeroMemory (Windows)
+
+    If CS_WIPE_BACKEND is not defined, the platform primitive is detected at compile time and
+    the fill engine is used as fallback. Define it to one of the values above to force a backend.
+    bench/wipe_bench measures the volatile loop, the engine and the platform primitive side by side.
+*/
+#define CS_WIPE_VOLATILE 1
+#define CS_WIPE_ENGINE 2
+#define CS_WIPE_EXPLICIT_BZERO 3
+#define CS_WIPE_MEMSET_S 4
+#define CS_WIPE_SECUREZERO 5
+
+// platform wipe primitive, 0 if there is none. Detected even if CS_WIPE_BACKEND forces another
+// backend, so wipe_bench can compare all of them in one run.
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+#   define CS_WIPE_PLATFORM CS_WIPE_EXPLICIT_BZERO
+#elif defined(__OpenBSD__) || defined(__FreeBSD__)
+#   define CS_WIPE_PLATFORM CS_WIPE_EXPLICIT_BZERO
+#elif defined(_WIN32)
+#   define CS_WIPE_PLATFORM CS_WIPE_SECUREZERO
+#elif defined(__STDC_LIB_EXT1__) || defined(__APPLE__)
+#   define CS_WIPE_PLATFORM CS_WIPE_MEMSET_S
+#else
+#   define CS_WIPE_PLATFORM 0
+#endif
+
+#ifndef CS_WIPE_BACKEND
+#   if CS_WIPE_PLATFORM != 0
+#       define CS_WIPE_BACKEND CS_WIPE_PLATFORM
+#   else
+#       define CS_WIPE_BACKEND CS_WIPE_ENGINE
+#   endif
+#endif
+
+#if CS_WIPE_BACKEND == CS_WIPE_EXPLICIT_BZERO || CS_WIPE_PLATFORM == CS_WIPE_EXPLICIT_BZERO
+#   include <string.h>
+#   if defined(__FreeBSD__)
+#       include <strings.h>
+#   endif
+#endif
+#if CS_WIPE_BACKEND == CS_WIPE_MEMSET_S || CS_WIPE_PLATFORM == CS_WIPE_MEMSET_S
+#   include <string.h>
+#   if defined(__APPLE__)
+// <string.h> only declares memset_s if __STDC_WANT_LIB_EXT1__ was set before its first inclusion,
+// which depends on the include order of the translation unit
+extern "C" int memset_s( void* s, size_t smax, int c, size_t n );
+#   endif
+#endif
+#if CS_WIPE_BACKEND == CS_WIPE_SECUREZERO || CS_WIPE_PLATFORM == CS_WIPE_SECUREZERO
+// keep the min/max macros and the rarely used APIs of windows.h out of every including translation unit
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#       define CS_UNDEF_NOMINMAX
+#   endif
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#       define CS_UNDEF_WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#   ifdef CS_UNDEF_NOMINMAX
+#       undef NOMINMAX
+#       undef CS_UNDEF_NOMINMAX
+#   endif
+#   ifdef CS_UNDEF_WIN32_LEAN_AND_MEAN
+#       undef WIN32_LEAN_AND_MEAN
+#       undef CS_UNDEF_WIN32_LEAN_AND_MEAN
+#   endif
+#endif
+#if CS_WIPE_BACKEND < CS_WIPE_VOLATILE || CS_WIPE_BACKEND > CS_WIPE_SECUREZERO
+#   error "invalid CS_WIPE_BACKEND"
+#endif
+
+
+/* cpu feature detection
+    evaluated once per process, used for runtime dispatch of SIMD kernels
+*/
+namespace cs {
+namespace detail {
+
+struct cpu_features {
+    bool avx2;
+    bool avx512f;
+};
+
+inline cpu_features detect_cpu() noexcept {
+    cpu_features features = { false, false };
+#if defined(CS_SIMD) && (defined(CS_CLANG) || defined(CS_GCC))
+    __builtin_cpu_init();
+    features.avx2 = __builtin_cpu_supports("avx2") != 0;
+    features.avx512f = __builtin_cpu_supports("avx512f") != 0;
+#elif defined(CS_SIMD) && defined(CS_MSVC)
+    int regs[4] = {};
+    __cpuid(regs, 0);
+    if ( regs[0] < 7 )
+        return features;
+    __cpuid(regs, 1);
+    // the OS has to save the extended registers on context switches
+    if ( !(regs[2] & (1 << 27)) )
+        return features;
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(regs, 7, 0);
+    features.avx2 = (xcr0 & 0x06) == 0x06 && (regs[1] & (1 << 5));
+    features.avx512f = (xcr0 & 0xe6) == 0xe6 && (regs[1] & (1 << 16));
+#endif
+    return features;
+}
+
+inline const cpu_features& cpu() noexcept {
+    static const cpu_features features = detect_cpu();
+    return features;
+}
+
+}
+}
+
 
 /* volatile memory routines
     you should not call them in tight loops
 */
 namespace cs {
 
-/* memset
-    set num bytes of ptr to value
+/* volatile_memset
+    set num bytes of ptr to value, one volatile store per byte.
+    Reference implementation of cs::memset, kept as baseline for benchmarks.
 */
 #ifdef CS_MSVC
 #   pragma optimize("", off)
 #endif
-static volatile void* CS_NO_OPTIMIZE memset( void* ptr, int value, size_t num )  {
+inline volatile void* CS_NO_OPTIMIZE volatile_memset( void* ptr, int value, size_t num )  {
     volatile char* char_ptr = static_cast<volatile char*>(ptr);
     while( num-- > 0) {
         *char_ptr = static_cast<char>( value );
@@ -105,13 +352,14 @@ static volatile void* CS_NO_OPTIMIZE memset( void* ptr, int value, size_t num )
 #   pragma optimize("", on)
 #endif
 
-/* memzero
-    set num bytes of ptr to zero
+/* volatile_memzero
+    set num bytes of ptr to zero, one volatile store per byte.
+    Reference implementation of cs::memzero, kept as baseline for benchmarks.
 */
 #ifdef CS_MSVC
 #   pragma optimize("", off)
 #endif
-static void CS_NO_OPTIMIZE memzero( void* ptr, size_t num ) {
+inline void CS_NO_OPTIMIZE volatile_memzero( void* ptr, size_t num ) {
     volatile char* char_ptr = static_cast<volatile char*>(ptr);
     while( num-- > 0) {
         *char_ptr = 0;
@@ -124,239 +372,1648 @@ static void CS_NO_OPTIMIZE memzero( void* ptr, size_t num ) {
 
 }
 
-/* securememory zero classes
+/* secure fill engine
+    fills memory with aligned word or SIMD stores. The stores cannot be elided since
+    every fill ends with CS_BARRIER on the filled memory.
 */
 namespace cs {
+namespace detail {
 
-/*
-    Zeros all bytes of *this on destructor call. Parent type needs to be
-    supplied to zero the correct size.
+typedef void (*fill_kernel)(unsigned char*, unsigned char, size_t);
 
-        struct MyType : sm::zero<MyType> {
-            ...
-        };
+/* word-wide fill
+    byte stores up to the next 8 byte boundary, aligned 8 byte stores and a byte tail
 */
-template < class T >
-struct zero {
-    typedef T parent_type;
+inline void fill_words(unsigned char* ptr, unsigned char value, size_t num) noexcept {
+    const uint64_t word = UINT64_C(0x0101010101010101) * value;
+    while ( num > 0 && (reinterpret_cast<uintptr_t>(ptr) & 7) ) {
+        *ptr++ = value;
+        --num;
+    }
+    for ( ; num >= 8; num -= 8, ptr += 8 ) {
+        std::memcpy(ptr, &word, 8);
+    }
+    while ( num-- > 0 ) {
+        *ptr++ = value;
+    }
+}
 
-#ifdef CS_MSVC
-#   pragma optimize("", off)
-#endif
-    CS_NO_OPTIMIZE ~zero() {
-        memzero( static_cast<void*>(this), sizeof(parent_type));
+#if defined(CS_SSE2)
+inline void fill_sse2(unsigned char* ptr, unsigned char value, size_t num) noexcept {
+    const size_t head = (16 - (reinterpret_cast<uintptr_t>(ptr) & 15)) & 15;
+    if ( head > num ) {
+        fill_words(ptr, value, num);
+        return;
     }
-#ifdef CS_MSVC
-#   pragma optimize("", on)
-#endif
+    fill_words(ptr, value, head);
+    ptr += head;
+    num -= head;
 
-    /* member set_zero call
-     *  should be used to zero dynamic memory before ~zero is called.
-    */
-#ifdef CS_MSVC
-#   pragma optimize("", off)
-#endif
-    void CS_NO_OPTIMIZE set_zero(void* ptr, size_t length) {
-        memzero( static_cast<void*>(ptr), length);
+    const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+    for ( ; num >= 64; num -= 64, ptr += 64 ) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(ptr), v);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ptr + 16), v);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ptr + 32), v);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ptr + 48), v);
     }
-    template < class U >
-    void CS_NO_OPTIMIZE set_zero(U* ptr) {
-        zero(ptr, sizeof(U));
+    for ( ; num >= 16; num -= 16, ptr += 16 ) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(ptr), v);
     }
-#ifdef CS_MSVC
-#   pragma optimize("", on)
+    fill_words(ptr, value, num);
+}
 #endif
-};
 
-/*
-    Zeros all bytes in deallocate/destroy method calls. Base should be a
-    std::allocator or compatible class.
-*/
-template < class Base >
-struct zero_plugin_allocator : Base {
-    typedef Base base_type;
-    typedef typename Base::value_type value_type;
-    typedef typename Base::pointer pointer;
+#if defined(CS_SIMD)
+CS_TARGET_AVX2 inline void fill_avx2(unsigned char* ptr, unsigned char value, size_t num) noexcept {
+    const size_t head = (32 - (reinterpret_cast<uintptr_t>(ptr) & 31)) & 31;
+    if ( head > num ) {
+        fill_words(ptr, value, num);
+        return;
+    }
+    fill_words(ptr, value, head);
+    ptr += head;
+    num -= head;
 
-#ifdef CS_MSVC
-#   pragma optimize("", off)
-#endif
-    /*  destroy objects
-    */
-    void CS_NO_OPTIMIZE destroy( pointer p ) {
-        memzero( static_cast<void*>(p), sizeof(value_type));
-        Base::destroy(p);
+    const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+    for ( ; num >= 128; num -= 128, ptr += 128 ) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ptr), v);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ptr + 32), v);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ptr + 64), v);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ptr + 96), v);
     }
-    template < class U >
-    void CS_NO_OPTIMIZE destroy( U* p ) {
-        memzero( static_cast<void*>(p), sizeof(U));
-        Base::template destroy<U>(p);
+    for ( ; num >= 32; num -= 32, ptr += 32 ) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ptr), v);
     }
+    fill_words(ptr, value, num);
+}
 
-    /*  deallocate objects
-    */
-    void CS_NO_OPTIMIZE deallocate( pointer p, size_t n ) {
-        memzero(static_cast<void*>(p), sizeof(value_type) * n);
-        Base::deallocate(p, n);
+CS_TARGET_AVX512 inline void fill_avx512(unsigned char* ptr, unsigned char value, size_t num) noexcept {
+    const size_t head = (64 - (reinterpret_cast<uintptr_t>(ptr) & 63)) & 63;
+    if ( head > num ) {
+        fill_words(ptr, value, num);
+        return;
     }
-#ifdef CS_MSVC
-#   pragma optimize("", on)
+    fill_words(ptr, value, head);
+    ptr += head;
+    num -= head;
+
+    const __m512i v = _mm512_set1_epi64(static_cast<long long>(UINT64_C(0x0101010101010101) * value));
+    for ( ; num >= 256; num -= 256, ptr += 256 ) {
+        _mm512_store_si512(ptr, v);
+        _mm512_store_si512(ptr + 64, v);
+        _mm512_store_si512(ptr + 128, v);
+        _mm512_store_si512(ptr + 192, v);
+    }
+    for ( ; num >= 64; num -= 64, ptr += 64 ) {
+        _mm512_store_si512(ptr, v);
+    }
+    fill_words(ptr, value, num);
+}
 #endif
-};
 
-/*  Standalone zero-allocator
-*/
-#ifdef CS_STL_INTEROP
-template < class T >
-struct std_zero_allocator : zero_plugin_allocator< std::allocator<T> > {};
+// select the widest fill kernel supported by the running cpu
+inline fill_kernel select_fill_kernel() noexcept {
+#if defined(CS_SIMD)
+    if ( cpu().avx512f )
+        return &fill_avx512;
+    if ( cpu().avx2 )
+        return &fill_avx2;
+#endif
+#if defined(CS_SSE2)
+    return &fill_sse2;
+#else
+    return &fill_words;
 #endif
+}
 
-// A compile-time string class. All operators and routines are constexpr.
-// Checking for ranges/content can happen at compile-time.
-template < class CharType, size_t N >
-struct ctstr {
-    typedef CharType char_type;
-    static constexpr size_t ct_size = N;
+// fill num bytes of ptr with value, small sizes skip the dispatch
+inline void fill(void* ptr, unsigned char value, size_t num) noexcept {
+    unsigned char* bytes = static_cast<unsigned char*>(ptr);
+    if ( num < 64 ) {
+        fill_words(bytes, value, num);
+    } else {
+        static const fill_kernel kernel = select_fill_kernel();
+        kernel(bytes, value, num);
+    }
+    CS_BARRIER(ptr);
+}
 
-    // construct an empty ctstr instance
-    constexpr ctstr() noexcept : str{}, len(N) {}
+}
 
-    // construct a ctstr from a char array
-    template < size_t Y >
-    constexpr ctstr(const char_type (&_str)[Y] ) noexcept : str{}, len(Y) {
-        static_assert(N == Y, "invalid sizes");
-        for ( size_t i = 0; N > i; ++i ) {
-           str[i] = _str[i];
-        }
-    }
+}
 
-    // construct a ctstr instance from another one, allowing nested processing of ctstr instances
-    template < size_t Y >
-    constexpr ctstr(const ctstr<char_type,Y>& _other ) noexcept : str{}, len(Y) {
-        static_assert (N == Y, "invalid sizes");
-        for ( size_t i = 0; N > i; ++i ) {
-            str[i] = _other.str[i];
-        }
-    }
+/* xor engine
+    XORs memory with a repeating 8 byte pattern, used by block functors.
+    Loads and stores are unaligned, so the pattern phase always starts at src[0].
+*/
+namespace cs {
+namespace detail {
 
-    // return pointer to string elements
-    constexpr const char_type* const get() const noexcept { return &str[0]; }
+typedef void (*xor_kernel)(const unsigned char*, unsigned char*, size_t, uint64_t);
 
-    // statitcally range-checked accessor
-    constexpr const char_type operator [] ( size_t _index ) const {
-        return ( _index < len ) ? str[_index] : throw std::out_of_range("index out of range");
+inline void xor_words(const unsigned char* src, unsigned char* dst, size_t num, uint64_t pattern) noexcept {
+    for ( ; num >= 8; num -= 8, src += 8, dst += 8 ) {
+        uint64_t word;
+        std::memcpy(&word, src, 8);
+        word ^= pattern;
+        std::memcpy(dst, &word, 8);
     }
-
-    // return size of string in elements
-    constexpr size_t size() const noexcept {
-        return len;
+    unsigned char bytes[8];
+    std::memcpy(bytes, &pattern, 8);
+    for ( size_t i = 0; num > i; ++i ) {
+        dst[i] = static_cast<unsigned char>(src[i] ^ bytes[i]);
     }
+}
 
-    // compile-time comparison with other strings
-    template < size_t Y >
-    constexpr bool operator == ( const char (&_str)[Y] ) const noexcept {
-        if ( Y != N )
-            return false;
-        return equal(_str);
+#if defined(CS_SSE2)
+inline void xor_sse2(const unsigned char* src, unsigned char* dst, size_t num, uint64_t pattern) noexcept {
+    const __m128i v = _mm_set1_epi64x(static_cast<long long>(pattern));
+    for ( ; num >= 64; num -= 64, src += 64, dst += 64 ) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_xor_si128(a, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_xor_si128(b, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_xor_si128(c, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_xor_si128(d, v));
     }
-    template < size_t Y >
-    constexpr bool operator == ( const ctstr<char_type,Y> _other ) const noexcept {
-        if ( Y != N )
-            return false;
-        return equal(_other.str);
+    for ( ; num >= 16; num -= 16, src += 16, dst += 16 ) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_xor_si128(a, v));
     }
-    template < size_t Y >
-    constexpr bool operator != ( const char (&_str)[Y] ) const noexcept {
-        if ( Y != N )
-            return true;
-        return !equal(_str);
+    xor_words(src, dst, num, pattern);
+}
+#endif
+
+#if defined(CS_SIMD)
+CS_TARGET_AVX2 inline void xor_avx2(const unsigned char* src, unsigned char* dst, size_t num, uint64_t pattern) noexcept {
+    const __m256i v = _mm256_set1_epi64x(static_cast<long long>(pattern));
+    for ( ; num >= 128; num -= 128, src += 128, dst += 128 ) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_xor_si256(a, v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_xor_si256(b, v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 64), _mm256_xor_si256(c, v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 96), _mm256_xor_si256(d, v));
     }
-    template < size_t Y >
-    constexpr bool operator != ( const ctstr<char_type,Y> _other ) const noexcept {
-        if ( Y != N )
-            return true;
-        return !equal(_other.str);
+    for ( ; num >= 32; num -= 32, src += 32, dst += 32 ) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_xor_si256(a, v));
     }
+    xor_words(src, dst, num, pattern);
+}
 
-private:
-    // compare with another string
-    template < size_t Y >
-    constexpr bool equal(const char (&_str)[Y] ) const noexcept {
-        for ( size_t i = 0; N > i; ++i ) {
-            if ( str[i] != _str[i] ) {
-                return false;
-            }
-        }
-        return true;
+CS_TARGET_AVX512 inline void xor_avx512(const unsigned char* src, unsigned char* dst, size_t num, uint64_t pattern) noexcept {
+    const __m512i v = _mm512_set1_epi64(static_cast<long long>(pattern));
+    for ( ; num >= 256; num -= 256, src += 256, dst += 256 ) {
+        const __m512i a = _mm512_loadu_si512(src);
+        const __m512i b = _mm512_loadu_si512(src + 64);
+        const __m512i c = _mm512_loadu_si512(src + 128);
+        const __m512i d = _mm512_loadu_si512(src + 192);
+        _mm512_storeu_si512(dst, _mm512_xor_si512(a, v));
+        _mm512_storeu_si512(dst + 64, _mm512_xor_si512(b, v));
+        _mm512_storeu_si512(dst + 128, _mm512_xor_si512(c, v));
+        _mm512_storeu_si512(dst + 192, _mm512_xor_si512(d, v));
     }
-
-public:
-    char_type str[N];
-    const size_t len;
-};
-// make helpers
-template < class CharType, size_t N >
-constexpr ctstr<CharType,N> make_ctstr(const CharType (&_str)[N] ) noexcept {
-    return ctstr<CharType,N>(_str);
+    for ( ; num >= 64; num -= 64, src += 64, dst += 64 ) {
+        const __m512i a = _mm512_loadu_si512(src);
+        _mm512_storeu_si512(dst, _mm512_xor_si512(a, v));
+    }
+    xor_words(src, dst, num, pattern);
 }
-template < class CharType, size_t N >
-constexpr ctstr<CharType,N> make_ctstr(const ctstr<CharType,N>& _other ) noexcept {
-    return ctstr<CharType,N>(_other);
+#endif
+
+// select the widest xor kernel supported by the running cpu
+inline xor_kernel select_xor_kernel() noexcept {
+#if defined(CS_SIMD)
+    if ( cpu().avx512f )
+        return &xor_avx512;
+    if ( cpu().avx2 )
+        return &xor_avx2;
+#endif
+#if defined(CS_SSE2)
+    return &xor_sse2;
+#else
+    return &xor_words;
+#endif
 }
 
-// applies a functor to every char of a ctstr and returns another one
-// functor is of the form CharType functor(CharType*,size_t len, size_t index)
-template < class CharType, size_t N, class Functor >
-constexpr ctstr<CharType,N> transform(const ctstr<CharType,N>& _other, Functor _functor) noexcept {
-    CharType values[N] = {};
-    for ( size_t i = 0; N > i; ++i ) {
-        values[i] = _functor(_other.get(),N,i);
+// dst = src ^ pattern for num bytes, src and dst may be equal
+inline void xor_pattern(const void* src, void* dst, size_t num, uint64_t pattern) noexcept {
+    const unsigned char* in = static_cast<const unsigned char*>(src);
+    unsigned char* out = static_cast<unsigned char*>(dst);
+    if ( num < 64 ) {
+        xor_words(in, out, num, pattern);
+    } else {
+        static const xor_kernel kernel = select_xor_kernel();
+        kernel(in, out, num, pattern);
     }
-    return ctstr<CharType,N>(values);
 }
-template < class CharType, size_t N, class Functor >
-constexpr ctstr<CharType,N> transform(const CharType (&_str)[N], Functor _functor) noexcept {
-    CharType values[N] = {};
-    for ( size_t i = 0; N > i; ++i ) {
-        values[i] = _functor(_str,N,i);
+
+// repeats the bytes of value to fill 8 bytes
+template < class T >
+inline uint64_t repeat_pattern(T value) noexcept {
+    static_assert(8 % sizeof(T) == 0, "invalid pattern element size");
+    unsigned char bytes[8];
+    for ( size_t i = 0; 8 > i; i += sizeof(T) ) {
+        std::memcpy(&bytes[i], &value, sizeof(T));
     }
-    return ctstr<CharType,N>(values);
+    uint64_t pattern;
+    std::memcpy(&pattern, bytes, 8);
+    return pattern;
 }
 
+// returns ptr, but the optimizer can no longer see what it points to. Keeps the compiler from
+// constant folding the decryption of constexpr data, which would embed the plaintext in the binary.
+template < class T >
+inline T* opaque(T* ptr) noexcept {
+#if defined(CS_CLANG) || defined(CS_GCC)
+    __asm__("" : "+r"(ptr));
+    return ptr;
+#else
+    T* volatile hidden = ptr;
+    return hidden;
+#endif
+}
 
-// construct a new ctstr instance with the specified Functor transformation
-template < class CharType, size_t N, class Functor >
-constexpr ctstr<CharType,N> construct_transform(const ctstr<CharType,N>& _other, Functor _functor ) noexcept {
-    CharType values[N] = {};
-    for ( size_t i = 0; N > i; ++i ) {
-        values[i] = _functor(_other.get(),N,i);
-    }
-    return ctstr<CharType,N>(values);
 }
-template < class CharType, size_t N, class Functor >
-constexpr ctstr<CharType,N> construct_transform(const CharType (&_str)[N], Functor _functor ) noexcept {
-    CharType values[N] = {};
-    for ( size_t i = 0; N > i; ++i ) {
-        values[i] = _functor(_str,N,i);
-    }
-    return ctstr<CharType,N>(values);
 }
 
-// A standard XOR functor for obfuscation
-template < int Key >
-struct xor_functor {
-    template < class CharType >
-    constexpr CharType operator () ( const CharType* str, size_t len, size_t index ) noexcept {
-        (void)len;
-        return str[index] ^ Key;
-    }
-};
+/**
+    CS_ENABLE_STATS
 
-// A view into an obfuscated_string instance.
-// Automatically zeroes all bytes on destruction of the object.
-// strview can only be passed by reference or pointer.
+    Opt-in instrumentation. With CS_ENABLE_STATS defined, decrypt calls and bytes, live strview
+    instances and bytes, and the number, bytes and duration of wipes are counted. Every thread
+    counts into its own record of relaxed atomics, which only that thread writes, so counting
+    needs no locked instructions. cs::stats() sums all records on demand.
+    Records of exited threads are reused by new threads and keep their counts. Counts of thread_local
+    destructors that run after a thread released its record go to a shared record with atomic adds.
+
+    Without CS_ENABLE_STATS all hooks are compiled out and cs::stats() returns zeros.
+*/
+#if defined(CS_ENABLE_STATS)
+#   define CS_STATS(call) call
+#else
+#   define CS_STATS(call) ((void)0)
+#endif
+
+namespace cs {
+
+// aggregated counters of all threads, see CS_ENABLE_STATS
+struct stats_snapshot {
+    static constexpr size_t histogram_size = 32;
+
+    uint64_t decrypt_calls;                 // decrypt, decrypt_into, decrypt_range and decrypt_to calls
+    uint64_t decrypt_bytes;                 // bytes of plaintext produced
+    uint64_t strview_live;                  // strview instances alive
+    uint64_t strview_live_bytes;            // bytes held by live strview instances
+    uint64_t wipe_calls;                    // cs::memzero calls
+    uint64_t wipe_bytes;                    // bytes wiped
+    uint64_t wipe_ns[histogram_size];       // wipes that took [2^i, 2^(i+1)) ns, bucket 0 includes 0 ns
+};
+
+#if defined(CS_ENABLE_STATS)
+constexpr bool stats_enabled = true;
+
+namespace detail {
+
+// counters of one thread
+struct thread_stats {
+    std::atomic<uint64_t> decrypt_calls{0};
+    std::atomic<uint64_t> decrypt_bytes{0};
+    std::atomic<uint64_t> views_created{0};
+    std::atomic<uint64_t> views_destroyed{0};
+    std::atomic<uint64_t> view_bytes_added{0};
+    std::atomic<uint64_t> view_bytes_removed{0};
+    std::atomic<uint64_t> wipe_calls{0};
+    std::atomic<uint64_t> wipe_bytes{0};
+    std::atomic<uint64_t> wipe_ns[stats_snapshot::histogram_size] = {};
+    std::atomic<bool> in_use{true};
+    thread_stats* next = nullptr;
+};
+
+// list of all records, records are never freed
+inline std::atomic<thread_stats*>& stats_list() noexcept {
+    static std::atomic<thread_stats*> head{nullptr};
+    return head;
+}
+
+// shared record of threads that already released their own, updated with atomic adds.
+// constant-initialized and trivially destructible, so it is usable during all static and thread exit destructors.
+inline thread_stats& retired_stats() noexcept {
+    static thread_stats record;
+    return record;
+}
+
+// record of the calling thread, trivially destructible so it stays valid during all thread_local destructors
+struct thread_stats_slot {
+    thread_stats* record;
+    bool retired;
+};
+inline thread_stats_slot& stats_slot() noexcept {
+    thread_local thread_stats_slot slot = { nullptr, false };
+    return slot;
+}
+
+// claims a record for the calling thread and releases it on thread exit. thread_local objects destroyed
+// after the handle still count, into retired_stats(), never into the released record another thread may own.
+// The hooks are noexcept, a thread that cannot allocate a record counts into retired_stats() as well.
+struct thread_stats_handle {
+    thread_stats_handle() noexcept {
+        stats_slot().record = claim();
+    }
+    ~thread_stats_handle() {
+        thread_stats_slot& slot = stats_slot();
+        thread_stats* record = slot.record;
+        slot.record = nullptr;
+        slot.retired = true;
+        if ( record )
+            record->in_use.store(false, std::memory_order_release);
+    }
+
+    // \return a released or new record, nullptr if none could be allocated
+    static thread_stats* claim() noexcept {
+        std::atomic<thread_stats*>& head = stats_list();
+        for ( thread_stats* it = head.load(std::memory_order_acquire); it; it = it->next ) {
+            bool expected = false;
+            if ( it->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire) )
+                return it;
+        }
+        thread_stats* record = new (std::nothrow) thread_stats();
+        if ( !record )
+            return nullptr;
+        record->next = head.load(std::memory_order_relaxed);
+        while ( !head.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed) ) {}
+        return record;
+    }
+};
+
+// record of the calling thread, nullptr once the thread released it or if it has none
+inline thread_stats* local_stats() noexcept {
+    thread_stats_slot& slot = stats_slot();
+    if ( !slot.record && !slot.retired ) {
+        thread_local thread_stats_handle handle;
+    }
+    return slot.record;
+}
+
+// an owned record is only written by its thread, a relaxed load and store is enough.
+// the shared retired record needs atomic adds.
+inline void stats_add(std::atomic<uint64_t>& _counter, uint64_t _value, bool _shared) noexcept {
+    if ( _shared )
+        _counter.fetch_add(_value, std::memory_order_relaxed);
+    else
+        _counter.store(_counter.load(std::memory_order_relaxed) + _value, std::memory_order_relaxed);
+}
+
+inline void stats_decrypt(size_t _bytes) noexcept {
+    thread_stats* owned = local_stats();
+    thread_stats& local = owned ? *owned : retired_stats();
+    stats_add(local.decrypt_calls, 1, !owned);
+    stats_add(local.decrypt_bytes, _bytes, !owned);
+}
+
+inline void stats_view(bool _created, size_t _bytes) noexcept {
+    thread_stats* owned = local_stats();
+    thread_stats& local = owned ? *owned : retired_stats();
+    stats_add(_created ? local.views_created : local.views_destroyed, 1, !owned);
+    stats_add(_created ? local.view_bytes_added : local.view_bytes_removed, _bytes, !owned);
+}
+
+inline void stats_wipe(size_t _bytes, uint64_t _ns) noexcept {
+    thread_stats* owned = local_stats();
+    thread_stats& local = owned ? *owned : retired_stats();
+    size_t bucket = 0;
+    while ( _ns > 1 && stats_snapshot::histogram_size - 1 > bucket ) {
+        _ns >>= 1;
+        ++bucket;
+    }
+    stats_add(local.wipe_calls, 1, !owned);
+    stats_add(local.wipe_bytes, _bytes, !owned);
+    stats_add(local.wipe_ns[bucket], 1, !owned);
+}
+
+inline uint64_t stats_now() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}
+
+// sums the counters of all threads, each counter is read without synchronizing with the others
+inline stats_snapshot stats() noexcept {
+    stats_snapshot result = {};
+    uint64_t created = 0, destroyed = 0, added = 0, removed = 0;
+    auto add = [&]( const detail::thread_stats& _record ) {
+        result.decrypt_calls += _record.decrypt_calls.load(std::memory_order_relaxed);
+        result.decrypt_bytes += _record.decrypt_bytes.load(std::memory_order_relaxed);
+        created += _record.views_created.load(std::memory_order_relaxed);
+        destroyed += _record.views_destroyed.load(std::memory_order_relaxed);
+        added += _record.view_bytes_added.load(std::memory_order_relaxed);
+        removed += _record.view_bytes_removed.load(std::memory_order_relaxed);
+        result.wipe_calls += _record.wipe_calls.load(std::memory_order_relaxed);
+        result.wipe_bytes += _record.wipe_bytes.load(std::memory_order_relaxed);
+        for ( size_t i = 0; stats_snapshot::histogram_size > i; ++i ) {
+            result.wipe_ns[i] += _record.wipe_ns[i].load(std::memory_order_relaxed);
+        }
+    };
+    for ( detail::thread_stats* it = detail::stats_list().load(std::memory_order_acquire); it; it = it->next ) {
+        add(*it);
+    }
+    add(detail::retired_stats());
+    // views may be created and destroyed on different threads, only the sums are meaningful
+    result.strview_live = created - destroyed;
+    result.strview_live_bytes = added - removed;
+    return result;
+}
+#else
+constexpr bool stats_enabled = false;
+
+inline stats_snapshot stats() noexcept {
+    return stats_snapshot{};
+}
+#endif
+
+}
+
+namespace cs {
+
+/* memset
+    set num bytes of ptr to value
+*/
+inline volatile void* memset( void* ptr, int value, size_t num ) noexcept {
+#if CS_WIPE_BACKEND == CS_WIPE_VOLATILE
+    return volatile_memset(ptr, value, num);
+#elif CS_WIPE_BACKEND == CS_WIPE_MEMSET_S
+    ::memset_s(ptr, num, value, num);
+    return ptr;
+#else
+    detail::fill(ptr, static_cast<unsigned char>(value), num);
+    return ptr;
+#endif
+}
+
+/* memzero
+    set num bytes of ptr to zero with the backend selected by CS_WIPE_BACKEND
+*/
+inline void memzero( void* ptr, size_t num ) noexcept {
+#if defined(CS_ENABLE_STATS)
+    const uint64_t start = detail::stats_now();
+#endif
+#if CS_WIPE_BACKEND == CS_WIPE_VOLATILE
+    volatile_memzero(ptr, num);
+#elif CS_WIPE_BACKEND == CS_WIPE_ENGINE
+    detail::fill(ptr, 0, num);
+#elif CS_WIPE_BACKEND == CS_WIPE_EXPLICIT_BZERO
+    ::explicit_bzero(ptr, num);
+#elif CS_WIPE_BACKEND == CS_WIPE_MEMSET_S
+    ::memset_s(ptr, num, 0, num);
+#elif CS_WIPE_BACKEND == CS_WIPE_SECUREZERO
+    ::SecureZeroMemory(ptr, num);
+#endif
+#if defined(CS_ENABLE_STATS)
+    detail::stats_wipe(num, detail::stats_now() - start);
+#endif
+}
+
+namespace detail {
+
+// the fill engine, regardless of CS_WIPE_BACKEND
+inline void engine_memzero( void* ptr, size_t num ) noexcept {
+    fill(ptr, 0, num);
+}
+
+#if CS_WIPE_PLATFORM != 0
+// the platform primitive detected as CS_WIPE_PLATFORM, regardless of CS_WIPE_BACKEND
+inline void platform_memzero( void* ptr, size_t num ) noexcept {
+#if CS_WIPE_PLATFORM == CS_WIPE_EXPLICIT_BZERO
+    ::explicit_bzero(ptr, num);
+#elif CS_WIPE_PLATFORM == CS_WIPE_MEMSET_S
+    ::memset_s(ptr, num, 0, num);
+#elif CS_WIPE_PLATFORM == CS_WIPE_SECUREZERO
+    ::SecureZeroMemory(ptr, num);
+#endif
+}
+#endif
+
+}
+
+// name of the selected memzero backend
+constexpr const char* wipe_backend() noexcept {
+#if CS_WIPE_BACKEND == CS_WIPE_VOLATILE
+    return "volatile";
+#elif CS_WIPE_BACKEND == CS_WIPE_ENGINE
+    return "engine";
+#elif CS_WIPE_BACKEND == CS_WIPE_EXPLICIT_BZERO
+    return "explicit_bzero";
+#elif CS_WIPE_BACKEND == CS_WIPE_MEMSET_S
+    return "memset_s";
+#elif CS_WIPE_BACKEND == CS_WIPE_SECUREZERO
+    return "SecureZeroMemory";
+#endif
+}
+
+}
+
+/* securememory zero classes
+*/
+namespace cs {
+
+/*
+    Zeros all bytes of *this on destructor call. Parent type needs to be
+    supplied to zero the correct size.
+
+        struct MyType : sm::zero<MyType> {
+            ...
+        };
+*/
+template < class T >
+struct zero {
+    typedef T parent_type;
+
+    // memzero is guaranteed by its backend, no need to turn off optimization here
+    ~zero() {
+        memzero( static_cast<void*>(this), sizeof(parent_type));
+    }
+
+    /* member set_zero call
+     *  should be used to zero dynamic memory before ~zero is called.
+    */
+    void set_zero(void* ptr, size_t length) {
+        memzero( static_cast<void*>(ptr), length);
+    }
+    template < class U >
+    void set_zero(U* ptr) {
+        set_zero(static_cast<void*>(ptr), sizeof(U));
+    }
+};
+
+/*
+    Zeros all bytes in deallocate/destroy method calls. Base should be a
+    std::allocator or compatible class.
+*/
+template < class Base >
+struct zero_plugin_allocator : Base {
+    typedef Base base_type;
+    typedef typename Base::value_type value_type;
+    typedef typename Base::pointer pointer;
+
+    // rebinding keeps the wiping layer around the rebound Base
+    template < class U >
+    struct rebind {
+        typedef zero_plugin_allocator< typename std::allocator_traits<Base>::template rebind_alloc<U> > other;
+    };
+
+    // stateful Base allocators, e.g. over a memory pool, are constructed like Base
+    using Base::Base;
+    zero_plugin_allocator() = default;
+    template < class OtherBase >
+    zero_plugin_allocator( const zero_plugin_allocator<OtherBase>& _other ) : Base(static_cast<const OtherBase&>(_other)) {}
+
+    /*  destroy objects
+        the storage is wiped after the destructor ran, so owned resources are still released.
+        opaque keeps the compiler's object size analysis from assuming p points to a single member.
+    */
+    void destroy( pointer p ) {
+        Base::destroy(p);
+        memzero( static_cast<void*>(detail::opaque(p)), sizeof(value_type));
+    }
+    template < class U >
+    void destroy( U* p ) {
+        Base::template destroy<U>(p);
+        memzero( static_cast<void*>(detail::opaque(p)), sizeof(U));
+    }
+
+    /*  deallocate objects
+    */
+    void deallocate( pointer p, size_t n ) {
+        memzero(static_cast<void*>(p), sizeof(value_type) * n);
+        Base::deallocate(p, n);
+    }
+};
+
+/*  Standalone zero-allocator
+*/
+#ifdef CS_STL_INTEROP
+template < class T >
+struct std_zero_allocator : zero_plugin_allocator< std::allocator<T> > {};
+#endif
+
+// A compile-time string class. All operators and routines are constexpr.
+// Checking for ranges/content can happen at compile-time.
+// ctstr is a trivially copyable aggregate of exactly N elements, its size is purely compile-time.
+// Construct instances with make_ctstr or aggregate initialization.
+template < class CharType, size_t N >
+struct ctstr {
+    typedef CharType char_type;
+    static constexpr size_t ct_size = N;
+
+    // return pointer to string elements
+    constexpr const char_type* get() const noexcept { return &str[0]; }
+
+    // statitcally range-checked accessor
+    constexpr const char_type operator [] ( size_t _index ) const {
+        return ( _index < N ) ? str[_index] : throw std::out_of_range("index out of range");
+    }
+
+    // return size of string in elements
+    constexpr size_t size() const noexcept {
+        return N;
+    }
+
+    // compile-time comparison with other strings
+    template < size_t Y >
+    constexpr bool operator == ( const char (&_str)[Y] ) const noexcept {
+        if ( Y != N )
+            return false;
+        return equal(_str);
+    }
+    template < size_t Y >
+    constexpr bool operator == ( const ctstr<char_type,Y> _other ) const noexcept {
+        if ( Y != N )
+            return false;
+        return equal(_other.str);
+    }
+    template < size_t Y >
+    constexpr bool operator != ( const char (&_str)[Y] ) const noexcept {
+        if ( Y != N )
+            return true;
+        return !equal(_str);
+    }
+    template < size_t Y >
+    constexpr bool operator != ( const ctstr<char_type,Y> _other ) const noexcept {
+        if ( Y != N )
+            return true;
+        return !equal(_other.str);
+    }
+
+private:
+    // compare with another string
+    template < class T, size_t Y >
+    constexpr bool equal(const T (&_str)[Y] ) const noexcept {
+        for ( size_t i = 0; N > i; ++i ) {
+            if ( str[i] != _str[i] ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    char_type str[N];
+};
+
+// layout guarantees, ctstr instances may be copied with memcpy
+static_assert(sizeof(ctstr<char,7>) == 7 * sizeof(char), "ctstr must only hold its elements");
+static_assert(sizeof(ctstr<char16_t,7>) == 7 * sizeof(char16_t), "ctstr must only hold its elements");
+static_assert(sizeof(ctstr<char32_t,7>) == 7 * sizeof(char32_t), "ctstr must only hold its elements");
+static_assert(std::is_trivially_copyable<ctstr<char,7>>::value, "ctstr must be trivially copyable");
+static_assert(std::is_standard_layout<ctstr<char,7>>::value, "ctstr must be standard layout");
+static_assert(std::is_aggregate<ctstr<char,7>>::value, "ctstr must be an aggregate");
+
+// make helpers
+template < class CharType, size_t N >
+constexpr ctstr<CharType,N> make_ctstr(const CharType (&_str)[N] ) noexcept {
+    ctstr<CharType,N> result{};
+    for ( size_t i = 0; N > i; ++i ) {
+        result.str[i] = _str[i];
+    }
+    return result;
+}
+template < class CharType, size_t N >
+constexpr ctstr<CharType,N> make_ctstr(const ctstr<CharType,N>& _other ) noexcept {
+    return _other;
+}
+
+/* block protocol
+    Functors are called per element: CharType functor(const CharType* str, size_t len, size_t index).
+    They may additionally implement
+
+        void apply_block(const CharType* src, CharType* dst, size_t offset, size_t count) const
+
+    which writes count transformed elements to dst, where src[0] is the element at index offset of
+    the string. Runtime decryption uses apply_block if available, encryption never does.
+
+    Constant evaluation uses the per-element call, unless the functor implements
+
+        constexpr void apply_all(const CharType* src, CharType* dst, size_t count) const
+
+    which transforms a whole string and lets functors share work between elements at compile time.
+*/
+namespace detail {
+
+template < class Functor, class CharType, class = void >
+struct has_apply_block : std::false_type {};
+template < class Functor, class CharType >
+struct has_apply_block< Functor, CharType, std::void_t<decltype( std::declval<const Functor&>().apply_block(
+    std::declval<const CharType*>(), std::declval<CharType*>(), size_t(), size_t()) )> > : std::true_type {};
+
+template < class Functor, class CharType, class = void >
+struct has_apply_all : std::false_type {};
+template < class Functor, class CharType >
+struct has_apply_all< Functor, CharType, std::void_t<decltype( std::declval<const Functor&>().apply_all(
+    std::declval<const CharType*>(), std::declval<CharType*>(), size_t()) )> > : std::true_type {};
+
+// transforms count elements of the len elements long string base, starting at offset, into dst
+template < class CharType, class Functor >
+inline void apply_functor(Functor& _functor, const CharType* _base, size_t _len, CharType* _dst, size_t _offset, size_t _count) {
+    if constexpr ( has_apply_block<Functor,CharType>::value ) {
+        (void)_len;
+        _functor.apply_block(_base + _offset, _dst, _offset, _count);
+    } else {
+        for ( size_t i = 0; _count > i; ++i ) {
+            _dst[i] = _functor(_base, _len, _offset + i);
+        }
+    }
+}
+
+// decrypts all _len elements of _src into _dst, out-of-line and shared by all string lengths
+// \return number of written elements
+template < class CharType, class Functor >
+CS_NOINLINE size_t decrypt_kernel(const Functor& _functor, const CharType* _src, size_t _len, CharType* _dst, size_t _cap) {
+    if ( _cap < _len )
+        throw std::length_error("destination too small");
+    Functor f = _functor;
+    apply_functor(f, opaque(_src), _len, _dst, 0, _len);
+    return _len;
+}
+
+// compares _input against the plaintext of the _len elements long _crypted string, without decrypting it.
+// The input is encrypted with _functor instead and compared in constant time with respect to its contents.
+// _input may omit a trailing null element of the plaintext. Per-element functors need a _scratch buffer
+// of _len elements for the padded input, block functors work on a small stack buffer.
+template < class CharType, class Functor >
+bool encrypted_equals(Functor& _functor, const CharType* _crypted, size_t _len, const CharType* _input, size_t _size, CharType* _scratch) {
+    if ( _size != _len && _size + 1 != _len )
+        return false;
+
+    typedef typename std::make_unsigned<CharType>::type unsigned_type;
+    const CharType* crypted = opaque(_crypted);
+    unsigned_type diff = 0;
+    if constexpr ( has_apply_block<Functor,CharType>::value ) {
+        (void)_scratch;
+        const size_t block = 64;
+        CharType in[block];
+        CharType out[block];
+        for ( size_t offset = 0; _len > offset; offset += block ) {
+            const size_t count = ( _len - offset < block ) ? _len - offset : block;
+            for ( size_t i = 0; count > i; ++i ) {
+                in[i] = ( offset + i < _size ) ? _input[offset + i] : CharType();
+            }
+            _functor.apply_block(in, out, offset, count);
+            for ( size_t i = 0; count > i; ++i ) {
+                diff |= static_cast<unsigned_type>(static_cast<unsigned_type>(out[i]) ^ static_cast<unsigned_type>(crypted[offset + i]));
+            }
+        }
+        memzero(in, sizeof(in));
+        memzero(out, sizeof(out));
+    } else {
+        for ( size_t i = 0; _len > i; ++i ) {
+            _scratch[i] = ( i < _size ) ? _input[i] : CharType();
+        }
+        for ( size_t i = 0; _len > i; ++i ) {
+            const CharType out = _functor(static_cast<const CharType*>(_scratch), _len, i);
+            diff |= static_cast<unsigned_type>(static_cast<unsigned_type>(out) ^ static_cast<unsigned_type>(crypted[i]));
+        }
+        memzero(_scratch, sizeof(CharType) * _len);
+    }
+    return diff == 0;
+}
+
+// transforms all N elements of _str with apply_all or per element.
+// This is the encryption path, it never dispatches to the runtime apply_block kernels: those would
+// take the plaintext literal as input and so embed it in the binary whenever a cs::crypt call is not
+// constant-evaluated. Runtime kernels are only used by the decrypt entry points.
+template < class CharType, size_t N, class Functor >
+constexpr void transform_values(const CharType* _str, CharType (&_values)[N], Functor& _functor) {
+    if constexpr ( has_apply_all<Functor,CharType>::value ) {
+        _functor.apply_all(_str, &_values[0], N);
+    } else {
+        for ( size_t i = 0; N > i; ++i ) {
+            _values[i] = _functor(_str,N,i);
+        }
+    }
+}
+
+}
+
+// applies a functor to every char of a ctstr and returns another one
+// functor is of the form CharType functor(CharType*,size_t len, size_t index)
+template < class CharType, size_t N, class Functor >
+constexpr ctstr<CharType,N> transform(const ctstr<CharType,N>& _other, Functor _functor) noexcept {
+    ctstr<CharType,N> result{};
+    detail::transform_values(_other.get(), result.str, _functor);
+    return result;
+}
+template < class CharType, size_t N, class Functor >
+constexpr ctstr<CharType,N> transform(const CharType (&_str)[N], Functor _functor) noexcept {
+    ctstr<CharType,N> result{};
+    detail::transform_values(&_str[0], result.str, _functor);
+    return result;
+}
+
+
+// construct a new ctstr instance with the specified Functor transformation
+template < class CharType, size_t N, class Functor >
+constexpr ctstr<CharType,N> construct_transform(const ctstr<CharType,N>& _other, Functor _functor ) noexcept {
+    ctstr<CharType,N> result{};
+    detail::transform_values(_other.get(), result.str, _functor);
+    return result;
+}
+template < class CharType, size_t N, class Functor >
+constexpr ctstr<CharType,N> construct_transform(const CharType (&_str)[N], Functor _functor ) noexcept {
+    ctstr<CharType,N> result{};
+    detail::transform_values(&_str[0], result.str, _functor);
+    return result;
+}
+
+// A standard XOR functor for obfuscation
+// Every element is XORed with Key truncated to the element type, e.g. only the low byte for char.
+template < int Key >
+struct xor_functor {
+    template < class CharType >
+    constexpr CharType operator () ( const CharType* str, size_t len, size_t index ) noexcept {
+        (void)len;
+        return str[index] ^ Key;
+    }
+
+    // block protocol, XORs 8 bytes of repeated keys per step with SIMD kernels
+    template < class CharType >
+    void apply_block( const CharType* src, CharType* dst, size_t offset, size_t count ) const noexcept {
+        (void)offset;
+        if constexpr ( std::is_integral<CharType>::value && 8 % sizeof(CharType) == 0 ) {
+            const CharType key = static_cast<CharType>(Key);
+            detail::xor_pattern(src, dst, count * sizeof(CharType), detail::repeat_pattern(key));
+        } else {
+            for ( size_t i = 0; count > i; ++i ) {
+                dst[i] = src[i] ^ Key;
+            }
+        }
+    }
+};
+
+/* keystream generators
+    counter-based generators, every 64 byte block of keystream is a pure function of (seed, counter).
+    Any position of the keystream can be computed without generating the preceding ones.
+
+    A generator implements
+        static constexpr void block(uint64_t seed, uint64_t counter, uint64_t (&out)[8])
+    for constant evaluation and
+        static keystream_kernel select_kernel()
+    which returns the runtime kernel XORing whole blocks, SIMD kernels generate several blocks per step.
+*/
+namespace detail {
+
+// splitmix64 step, derives well distributed values from a seed
+constexpr uint64_t splitmix64( uint64_t value ) noexcept {
+    value += UINT64_C(0x9e3779b97f4a7c15);
+    value = (value ^ (value >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    value = (value ^ (value >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return value ^ (value >> 31);
+}
+
+// XORs blocks whole 64 byte keystream blocks into dst, starting at block counter
+typedef void (*keystream_kernel)(uint64_t seed, uint64_t counter, const unsigned char* src, unsigned char* dst, size_t blocks);
+
+// generic kernel, one Generator::block per step
+template < class Generator >
+inline void keystream_words(uint64_t seed, uint64_t counter, const unsigned char* src, unsigned char* dst, size_t blocks) noexcept {
+    uint64_t words[8] = {};
+    for ( ; blocks > 0; --blocks, ++counter, src += 64, dst += 64 ) {
+        Generator::block(seed, counter, words);
+        for ( size_t w = 0; 8 > w; ++w ) {
+            uint64_t word;
+            std::memcpy(&word, src + 8 * w, 8);
+            word ^= words[w];
+            std::memcpy(dst + 8 * w, &word, 8);
+        }
+    }
+    memzero(words, sizeof(words));
+}
+
+// xorshift64* applied twice to a counter-dependent state
+struct xorshift_generator {
+    static constexpr uint64_t increment = UINT64_C(0x9e3779b97f4a7c15);
+    static constexpr uint64_t multiplier = UINT64_C(0x2545f4914f6cdd1d);
+
+    static constexpr void block( uint64_t _seed, uint64_t _counter, uint64_t (&_out)[8] ) noexcept {
+        for ( size_t lane = 0; 8 > lane; ++lane ) {
+            uint64_t x = _seed ^ ((_counter * 8 + lane + 1) * increment);
+            for ( int round = 0; 2 > round; ++round ) {
+                x ^= x >> 12;
+                x ^= x << 25;
+                x ^= x >> 27;
+                x *= multiplier;
+            }
+            _out[lane] = x;
+        }
+    }
+
+    static keystream_kernel select_kernel() noexcept;
+};
+
+// PCG: 64 bit LCG with RXS-M-XS output, the LCG is advanced to the block in O(log counter)
+struct pcg_generator {
+    static constexpr uint64_t multiplier = UINT64_C(6364136223846793005);
+    static constexpr uint64_t increment = UINT64_C(1442695040888963407);
+
+    static constexpr uint64_t advance( uint64_t _state, uint64_t _delta ) noexcept {
+        uint64_t acc_mult = 1;
+        uint64_t acc_plus = 0;
+        uint64_t cur_mult = multiplier;
+        uint64_t cur_plus = increment;
+        while ( _delta > 0 ) {
+            if ( _delta & 1 ) {
+                acc_mult *= cur_mult;
+                acc_plus = acc_plus * cur_mult + cur_plus;
+            }
+            cur_plus = (cur_mult + 1) * cur_plus;
+            cur_mult *= cur_mult;
+            _delta >>= 1;
+        }
+        return acc_mult * _state + acc_plus;
+    }
+
+    static constexpr uint64_t output( uint64_t _state ) noexcept {
+        const uint64_t word = ((_state >> ((_state >> 59) + 5)) ^ _state) * UINT64_C(12605985483714917081);
+        return (word >> 43) ^ word;
+    }
+
+    static constexpr void block( uint64_t _seed, uint64_t _counter, uint64_t (&_out)[8] ) noexcept {
+        uint64_t state = advance(splitmix64(_seed), _counter * 8);
+        for ( size_t lane = 0; 8 > lane; ++lane ) {
+            state = state * multiplier + increment;
+            _out[lane] = output(state);
+        }
+    }
+
+    // consecutive blocks continue the LCG, only the first one is advanced
+    static void blocks( uint64_t _seed, uint64_t _counter, const unsigned char* _src, unsigned char* _dst, size_t _blocks ) noexcept {
+        uint64_t state = advance(splitmix64(_seed), _counter * 8);
+        for ( size_t i = 0; _blocks * 8 > i; ++i ) {
+            state = state * multiplier + increment;
+            uint64_t word;
+            std::memcpy(&word, _src + 8 * i, 8);
+            word ^= output(state);
+            std::memcpy(_dst + 8 * i, &word, 8);
+        }
+        memzero(&state, sizeof(state));
+    }
+
+    static keystream_kernel select_kernel() noexcept {
+        return &blocks;
+    }
+};
+
+// ChaCha with 8 rounds, the 256 bit key is derived from the seed
+struct chacha_generator {
+    static constexpr uint32_t constant[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+
+    static constexpr uint32_t rotl( uint32_t _value, int _count ) noexcept {
+        return (_value << _count) | (_value >> (32 - _count));
+    }
+    static constexpr void quarter( uint32_t (&_x)[16], size_t _a, size_t _b, size_t _c, size_t _d ) noexcept {
+        _x[_a] += _x[_b]; _x[_d] = rotl(_x[_d] ^ _x[_a], 16);
+        _x[_c] += _x[_d]; _x[_b] = rotl(_x[_b] ^ _x[_c], 12);
+        _x[_a] += _x[_b]; _x[_d] = rotl(_x[_d] ^ _x[_a], 8);
+        _x[_c] += _x[_d]; _x[_b] = rotl(_x[_b] ^ _x[_c], 7);
+    }
+
+    // the 8 key words of the state
+    static constexpr void key( uint64_t _seed, uint32_t (&_key)[8] ) noexcept {
+        for ( size_t i = 0; 4 > i; ++i ) {
+            const uint64_t value = splitmix64(_seed + i);
+            _key[2 * i] = static_cast<uint32_t>(value);
+            _key[2 * i + 1] = static_cast<uint32_t>(value >> 32);
+        }
+    }
+
+    static constexpr void block( uint64_t _seed, uint64_t _counter, uint64_t (&_out)[8] ) noexcept {
+        uint32_t state[16] = { constant[0], constant[1], constant[2], constant[3] };
+        uint32_t k[8] = {};
+        key(_seed, k);
+        for ( size_t i = 0; 8 > i; ++i ) {
+            state[4 + i] = k[i];
+        }
+        state[12] = static_cast<uint32_t>(_counter);
+        state[13] = static_cast<uint32_t>(_counter >> 32);
+
+        uint32_t x[16] = {};
+        for ( size_t i = 0; 16 > i; ++i ) {
+            x[i] = state[i];
+        }
+        for ( int round = 0; 4 > round; ++round ) {
+            quarter(x, 0, 4, 8, 12);
+            quarter(x, 1, 5, 9, 13);
+            quarter(x, 2, 6, 10, 14);
+            quarter(x, 3, 7, 11, 15);
+            quarter(x, 0, 5, 10, 15);
+            quarter(x, 1, 6, 11, 12);
+            quarter(x, 2, 7, 8, 13);
+            quarter(x, 3, 4, 9, 14);
+        }
+        for ( size_t i = 0; 8 > i; ++i ) {
+            _out[i] = static_cast<uint64_t>(x[2 * i] + state[2 * i]) |
+                      (static_cast<uint64_t>(x[2 * i + 1] + state[2 * i + 1]) << 32);
+        }
+    }
+
+    static keystream_kernel select_kernel() noexcept;
+};
+
+#if defined(CS_SSE2)
+/* ChaCha, 4 blocks per step
+    every vector holds one state word of 4 consecutive blocks, the results are transposed
+    back into block order before they are XORed into dst
+*/
+inline void chacha_sse2(uint64_t seed, uint64_t counter, const unsigned char* src, unsigned char* dst, size_t blocks) noexcept {
+    uint32_t k[8] = {};
+    chacha_generator::key(seed, k);
+    for ( ; blocks >= 4; blocks -= 4, counter += 4, src += 256, dst += 256 ) {
+        __m128i state[16];
+        for ( size_t i = 0; 4 > i; ++i ) {
+            state[i] = _mm_set1_epi32(static_cast<int>(chacha_generator::constant[i]));
+        }
+        for ( size_t i = 0; 8 > i; ++i ) {
+            state[4 + i] = _mm_set1_epi32(static_cast<int>(k[i]));
+        }
+        state[12] = _mm_set_epi32(static_cast<int>(counter + 3), static_cast<int>(counter + 2),
+                                  static_cast<int>(counter + 1), static_cast<int>(counter));
+        state[13] = _mm_set_epi32(static_cast<int>((counter + 3) >> 32), static_cast<int>((counter + 2) >> 32),
+                                  static_cast<int>((counter + 1) >> 32), static_cast<int>(counter >> 32));
+        state[14] = _mm_setzero_si128();
+        state[15] = _mm_setzero_si128();
+
+        __m128i x[16];
+        for ( size_t i = 0; 16 > i; ++i ) {
+            x[i] = state[i];
+        }
+#define CS_CHACHA_ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#define CS_CHACHA_QUARTER(a, b, c, d) \
+        x[a] = _mm_add_epi32(x[a], x[b]); x[d] = CS_CHACHA_ROTL(_mm_xor_si128(x[d], x[a]), 16); \
+        x[c] = _mm_add_epi32(x[c], x[d]); x[b] = CS_CHACHA_ROTL(_mm_xor_si128(x[b], x[c]), 12); \
+        x[a] = _mm_add_epi32(x[a], x[b]); x[d] = CS_CHACHA_ROTL(_mm_xor_si128(x[d], x[a]), 8); \
+        x[c] = _mm_add_epi32(x[c], x[d]); x[b] = CS_CHACHA_ROTL(_mm_xor_si128(x[b], x[c]), 7)
+        for ( int round = 0; 4 > round; ++round ) {
+            CS_CHACHA_QUARTER(0, 4, 8, 12);
+            CS_CHACHA_QUARTER(1, 5, 9, 13);
+            CS_CHACHA_QUARTER(2, 6, 10, 14);
+            CS_CHACHA_QUARTER(3, 7, 11, 15);
+            CS_CHACHA_QUARTER(0, 5, 10, 15);
+            CS_CHACHA_QUARTER(1, 6, 11, 12);
+            CS_CHACHA_QUARTER(2, 7, 8, 13);
+            CS_CHACHA_QUARTER(3, 4, 9, 14);
+        }
+#undef CS_CHACHA_QUARTER
+#undef CS_CHACHA_ROTL
+        for ( size_t g = 0; 4 > g; ++g ) {
+            const __m128i a0 = _mm_add_epi32(x[4 * g], state[4 * g]);
+            const __m128i a1 = _mm_add_epi32(x[4 * g + 1], state[4 * g + 1]);
+            const __m128i a2 = _mm_add_epi32(x[4 * g + 2], state[4 * g + 2]);
+            const __m128i a3 = _mm_add_epi32(x[4 * g + 3], state[4 * g + 3]);
+            const __m128i t0 = _mm_unpacklo_epi32(a0, a1);
+            const __m128i t1 = _mm_unpacklo_epi32(a2, a3);
+            const __m128i t2 = _mm_unpackhi_epi32(a0, a1);
+            const __m128i t3 = _mm_unpackhi_epi32(a2, a3);
+            const __m128i b[4] = { _mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+                                   _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3) };
+            for ( size_t i = 0; 4 > i; ++i ) {
+                const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 64 * i + 16 * g));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 64 * i + 16 * g), _mm_xor_si128(in, b[i]));
+            }
+        }
+    }
+    memzero(k, sizeof(k));
+    keystream_words<chacha_generator>(seed, counter, src, dst, blocks);
+}
+#endif
+
+#if defined(CS_SIMD)
+/* ChaCha, 8 blocks per step
+    same layout as chacha_sse2, the 128 bit halves hold blocks i and i + 4
+*/
+CS_TARGET_AVX2 inline void chacha_avx2(uint64_t seed, uint64_t counter, const unsigned char* src, unsigned char* dst, size_t blocks) noexcept {
+    uint32_t k[8] = {};
+    chacha_generator::key(seed, k);
+    for ( ; blocks >= 8; blocks -= 8, counter += 8, src += 512, dst += 512 ) {
+        __m256i state[16];
+        for ( size_t i = 0; 4 > i; ++i ) {
+            state[i] = _mm256_set1_epi32(static_cast<int>(chacha_generator::constant[i]));
+        }
+        for ( size_t i = 0; 8 > i; ++i ) {
+            state[4 + i] = _mm256_set1_epi32(static_cast<int>(k[i]));
+        }
+        int low[8] = {};
+        int high[8] = {};
+        for ( size_t i = 0; 8 > i; ++i ) {
+            low[i] = static_cast<int>(counter + i);
+            high[i] = static_cast<int>((counter + i) >> 32);
+        }
+        state[12] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low));
+        state[13] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(high));
+        state[14] = _mm256_setzero_si256();
+        state[15] = _mm256_setzero_si256();
+
+        __m256i x[16];
+        for ( size_t i = 0; 16 > i; ++i ) {
+            x[i] = state[i];
+        }
+        // rotations by 16 and 8 are byte shuffles
+        const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                               2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+        const __m256i rot8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                              3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+#define CS_CHACHA_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+#define CS_CHACHA_QUARTER(a, b, c, d) \
+        x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = _mm256_shuffle_epi8(_mm256_xor_si256(x[d], x[a]), rot16); \
+        x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = CS_CHACHA_ROTL(_mm256_xor_si256(x[b], x[c]), 12); \
+        x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = _mm256_shuffle_epi8(_mm256_xor_si256(x[d], x[a]), rot8); \
+        x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = CS_CHACHA_ROTL(_mm256_xor_si256(x[b], x[c]), 7)
+        for ( int round = 0; 4 > round; ++round ) {
+            CS_CHACHA_QUARTER(0, 4, 8, 12);
+            CS_CHACHA_QUARTER(1, 5, 9, 13);
+            CS_CHACHA_QUARTER(2, 6, 10, 14);
+            CS_CHACHA_QUARTER(3, 7, 11, 15);
+            CS_CHACHA_QUARTER(0, 5, 10, 15);
+            CS_CHACHA_QUARTER(1, 6, 11, 12);
+            CS_CHACHA_QUARTER(2, 7, 8, 13);
+            CS_CHACHA_QUARTER(3, 4, 9, 14);
+        }
+#undef CS_CHACHA_QUARTER
+#undef CS_CHACHA_ROTL
+        // transpose the words of two groups, so every vector holds 32 bytes of one block
+        for ( size_t g = 0; 4 > g; g += 2 ) {
+            __m256i b[2][4];
+            for ( size_t h = 0; 2 > h; ++h ) {
+                const size_t w = 4 * (g + h);
+                const __m256i a0 = _mm256_add_epi32(x[w], state[w]);
+                const __m256i a1 = _mm256_add_epi32(x[w + 1], state[w + 1]);
+                const __m256i a2 = _mm256_add_epi32(x[w + 2], state[w + 2]);
+                const __m256i a3 = _mm256_add_epi32(x[w + 3], state[w + 3]);
+                const __m256i t0 = _mm256_unpacklo_epi32(a0, a1);
+                const __m256i t1 = _mm256_unpacklo_epi32(a2, a3);
+                const __m256i t2 = _mm256_unpackhi_epi32(a0, a1);
+                const __m256i t3 = _mm256_unpackhi_epi32(a2, a3);
+                b[h][0] = _mm256_unpacklo_epi64(t0, t1);
+                b[h][1] = _mm256_unpackhi_epi64(t0, t1);
+                b[h][2] = _mm256_unpacklo_epi64(t2, t3);
+                b[h][3] = _mm256_unpackhi_epi64(t2, t3);
+            }
+            for ( size_t i = 0; 4 > i; ++i ) {
+                const __m256i first = _mm256_permute2x128_si256(b[0][i], b[1][i], 0x20);
+                const __m256i second = _mm256_permute2x128_si256(b[0][i], b[1][i], 0x31);
+                const size_t lo = 64 * i + 16 * g;
+                const size_t hi = 64 * (i + 4) + 16 * g;
+                const __m256i in_lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + lo));
+                const __m256i in_hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + hi));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + lo), _mm256_xor_si256(in_lo, first));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + hi), _mm256_xor_si256(in_hi, second));
+            }
+        }
+    }
+    memzero(k, sizeof(k));
+#if defined(CS_SSE2)
+    chacha_sse2(seed, counter, src, dst, blocks);
+#else
+    keystream_words<chacha_generator>(seed, counter, src, dst, blocks);
+#endif
+}
+
+// 64 bit multiplication of every lane with a constant, from 32 bit products
+CS_TARGET_AVX2 inline __m256i mul64_avx2(__m256i _value, uint64_t _factor) noexcept {
+    const __m256i low = _mm256_set1_epi64x(static_cast<long long>(_factor & 0xffffffff));
+    const __m256i high = _mm256_set1_epi64x(static_cast<long long>(_factor >> 32));
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(_value, 32), low),
+                                           _mm256_mul_epu32(_value, high));
+    return _mm256_add_epi64(_mm256_mul_epu32(_value, low), _mm256_slli_epi64(cross, 32));
+}
+
+// xorshift, the 8 lanes of a block in two vectors
+CS_TARGET_AVX2 inline void xorshift_avx2(uint64_t seed, uint64_t counter, const unsigned char* src, unsigned char* dst, size_t blocks) noexcept {
+    const uint64_t increment = xorshift_generator::increment;
+    const __m256i seeds = _mm256_set1_epi64x(static_cast<long long>(seed));
+    const __m256i step = _mm256_set1_epi64x(static_cast<long long>(8 * increment));
+    long long lanes[8] = {};
+    for ( size_t i = 0; 8 > i; ++i ) {
+        lanes[i] = static_cast<long long>((counter * 8 + i + 1) * increment);
+    }
+    __m256i v[2] = { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes)),
+                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + 4)) };
+    for ( ; blocks > 0; --blocks, src += 64, dst += 64 ) {
+        for ( size_t h = 0; 2 > h; ++h ) {
+            __m256i x = _mm256_xor_si256(seeds, v[h]);
+            for ( int round = 0; 2 > round; ++round ) {
+                x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 12));
+                x = _mm256_xor_si256(x, _mm256_slli_epi64(x, 25));
+                x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 27));
+                x = mul64_avx2(x, xorshift_generator::multiplier);
+            }
+            const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32 * h));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32 * h), _mm256_xor_si256(in, x));
+            v[h] = _mm256_add_epi64(v[h], step);
+        }
+    }
+}
+#endif
+
+inline keystream_kernel xorshift_generator::select_kernel() noexcept {
+#if defined(CS_SIMD) && defined(CS_LITTLE_ENDIAN)
+    if ( cpu().avx2 )
+        return &xorshift_avx2;
+#endif
+    return &keystream_words<xorshift_generator>;
+}
+
+inline keystream_kernel chacha_generator::select_kernel() noexcept {
+#if defined(CS_SIMD) && defined(CS_LITTLE_ENDIAN)
+    if ( cpu().avx2 )
+        return &chacha_avx2;
+#endif
+#if defined(CS_SSE2) && defined(CS_LITTLE_ENDIAN)
+    return &chacha_sse2;
+#else
+    return &keystream_words<chacha_generator>;
+#endif
+}
+
+}
+
+// A keystream functor for obfuscation
+// Every element is XORed with the keystream bytes at its position, least significant byte first.
+// The keystream is a function of (seed, position), so strings can be decrypted in any order.
+// At runtime whole keystream blocks are generated by the SIMD kernel of the generator.
+template < class Generator >
+struct keystream_functor {
+    typedef Generator generator_type;
+
+    constexpr explicit keystream_functor( uint64_t _seed ) noexcept : seed(_seed) {}
+
+    template < class CharType >
+    constexpr CharType operator () ( const CharType* str, size_t len, size_t index ) const noexcept {
+        (void)len;
+        typedef typename std::make_unsigned<CharType>::type unsigned_type;
+        return static_cast<CharType>(static_cast<unsigned_type>(str[index]) ^ key<CharType>(index));
+    }
+
+    // block protocol
+    template < class CharType >
+    void apply_block( const CharType* src, CharType* dst, size_t offset, size_t count ) const noexcept {
+        static_assert(std::is_integral<CharType>::value && 64 % sizeof(CharType) == 0, "invalid element type");
+#if defined(CS_LITTLE_ENDIAN)
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+        unsigned char* out = reinterpret_cast<unsigned char*>(dst);
+        uint64_t position = static_cast<uint64_t>(offset) * sizeof(CharType);
+        size_t remaining = count * sizeof(CharType);
+        uint64_t words[8] = {};
+        unsigned char stream[64];
+        static const detail::keystream_kernel kernel = Generator::select_kernel();
+        while ( remaining > 0 ) {
+            const size_t skip = static_cast<size_t>(position % 64);
+            if ( skip == 0 && remaining >= 64 ) {
+                // whole blocks
+                const size_t blocks = remaining / 64;
+                kernel(seed, position / 64, in, out, blocks);
+                in += blocks * 64;
+                out += blocks * 64;
+                position += blocks * 64;
+                remaining -= blocks * 64;
+                continue;
+            }
+            // partial head or tail block
+            const size_t num = ( 64 - skip < remaining ) ? 64 - skip : remaining;
+            Generator::block(seed, position / 64, words);
+            std::memcpy(stream, words, 64);
+            for ( size_t i = 0; num > i; ++i ) {
+                out[i] = static_cast<unsigned char>(in[i] ^ stream[skip + i]);
+            }
+            in += num;
+            out += num;
+            position += num;
+            remaining -= num;
+        }
+        memzero(words, sizeof(words));
+        memzero(stream, sizeof(stream));
+#else
+        typedef typename std::make_unsigned<CharType>::type unsigned_type;
+        for ( size_t i = 0; count > i; ++i ) {
+            dst[i] = static_cast<CharType>(static_cast<unsigned_type>(src[i]) ^ key<CharType>(offset + i));
+        }
+#endif
+    }
+
+    // whole-string transformation for constant evaluation, one keystream block per 64 bytes
+    template < class CharType >
+    constexpr void apply_all( const CharType* src, CharType* dst, size_t count ) const noexcept {
+        typedef typename std::make_unsigned<CharType>::type unsigned_type;
+        uint64_t words[8] = {};
+        uint64_t current = ~static_cast<uint64_t>(0);
+        for ( size_t i = 0; count > i; ++i ) {
+            const uint64_t position = static_cast<uint64_t>(i) * sizeof(CharType);
+            if ( position / 64 != current ) {
+                current = position / 64;
+                Generator::block(seed, current, words);
+            }
+            dst[i] = static_cast<CharType>(static_cast<unsigned_type>(src[i]) ^ extract<CharType>(words, position % 64));
+        }
+    }
+
+    uint64_t seed;
+
+private:
+    // keystream element at index
+    template < class CharType >
+    constexpr typename std::make_unsigned<CharType>::type key( size_t index ) const noexcept {
+        const uint64_t position = static_cast<uint64_t>(index) * sizeof(CharType);
+        uint64_t words[8] = {};
+        Generator::block(seed, position / 64, words);
+        return extract<CharType>(words, position % 64);
+    }
+
+    // element at _byte of a keystream block, assembled least significant byte first
+    template < class CharType >
+    static constexpr typename std::make_unsigned<CharType>::type extract( const uint64_t (&_words)[8], uint64_t _byte ) noexcept {
+        typedef typename std::make_unsigned<CharType>::type unsigned_type;
+        unsigned_type value = 0;
+        for ( size_t b = 0; sizeof(CharType) > b; ++b ) {
+            const uint64_t part = (_words[(_byte + b) / 8] >> (8 * ((_byte + b) % 8))) & 0xff;
+            value = static_cast<unsigned_type>(value | (part << (8 * b)));
+        }
+        return value;
+    }
+};
+
+typedef keystream_functor<detail::xorshift_generator> xorshift_keystream;
+typedef keystream_functor<detail::pcg_generator> pcg_keystream;
+typedef keystream_functor<detail::chacha_generator> chacha_keystream;
+
+// keystream functors with a compile-time seed, default constructible like xor_functor
+template < uint64_t Seed >
+struct xorshift_functor : xorshift_keystream {
+    constexpr xorshift_functor() noexcept : xorshift_keystream(Seed) {}
+};
+template < uint64_t Seed >
+struct pcg_functor : pcg_keystream {
+    constexpr pcg_functor() noexcept : pcg_keystream(Seed) {}
+};
+template < uint64_t Seed >
+struct chacha_functor : chacha_keystream {
+    constexpr chacha_functor() noexcept : chacha_keystream(Seed) {}
+};
+
+/* call-site keys
+    CS_CRYPT("...") encrypts a literal with a keystream seed derived from __FILE__, __LINE__, __COUNTER__
+    and CS_BUILD_SEED. All call sites share the functor type CS_SITE_KEYSTREAM, which holds the seed as a
+    runtime value, so distinct keys add no template instantiations and decrypt through the same code.
+    CS_CRYPT_WITH(Keystream, "...") uses another keystream functor type constructible from a seed.
+
+    CS_BUILD_SEED defaults to a fixed value, so builds are reproducible. Define it per project, e.g. from
+    a secret in the build system, to get keys no other project shares. CS_TIME_SEED opts in to a seed
+    hashed from __DATE__ and __TIME__, which differs for every build and every translation unit.
+
+    Keys depend on __COUNTER__, which counts per translation unit, and with CS_TIME_SEED on the compile
+    time. CS_CRYPT in an inline function or template defined in a header therefore expands to different
+    constants in different translation units, an ODR violation. Use cs::crypt with an explicit functor
+    in headers, CS_CRYPT only in source files.
+*/
+#ifndef CS_BUILD_SEED
+#   if defined(CS_TIME_SEED)
+#       define CS_BUILD_SEED ::cs::detail::fnv1a(__DATE__ " " __TIME__)
+#   else
+#       define CS_BUILD_SEED UINT64_C(0x6a09e667f3bcc908)
+#   endif
+#endif
+#ifndef CS_SITE_KEYSTREAM
+#   define CS_SITE_KEYSTREAM ::cs::xorshift_keystream
+#endif
+
+namespace detail {
+
+// FNV-1a hash of a null terminated string
+constexpr uint64_t fnv1a( const char* _str, uint64_t _hash = UINT64_C(0xcbf29ce484222325) ) noexcept {
+    for ( ; *_str; ++_str ) {
+        _hash = (_hash ^ static_cast<unsigned char>(*_str)) * UINT64_C(0x100000001b3);
+    }
+    return _hash;
+}
+
+// keystream seed of a call site
+constexpr uint64_t site_seed( const char* _file, uint64_t _line, uint64_t _counter, uint64_t _build ) noexcept {
+    return splitmix64(fnv1a(_file, splitmix64(_build)) ^ splitmix64((_line << 32) ^ _counter));
+}
+
+}
+
+#define CS_CRYPT_WITH(Keystream, str) \
+    ([]() { \
+        constexpr auto cs_crypted = ::cs::crypt(Keystream(::cs::detail::site_seed(__FILE__, __LINE__, __COUNTER__, CS_BUILD_SEED)), str); \
+        return cs_crypted; \
+    }())
+#define CS_CRYPT(str) CS_CRYPT_WITH(CS_SITE_KEYSTREAM, str)
+
+/**
+    CS_PROFILE
+
+    Opt-in per call site profiling. With CS_PROFILE defined, every cryptstr is tagged at compile time
+    with the file and line of its cs::crypt or CS_CRYPT call and a label, a hash of the encrypted
+    data, which identifies the string without revealing it. decrypt(), decrypt_into(), decrypt_static(),
+    decrypt_range() and decrypt_to() add one call and the elapsed ticks to the site's slot in a fixed table
+    of CS_PROFILE_SLOTS cache line sized entries. Ticks are TSC cycles on x86 and nanoseconds elsewhere.
+    cs::profile_sites() and cs::profile_dump() report the most expensive sites.
+
+    Profiling builds contain the source file names of all tagged sites. Without CS_PROFILE the tags and
+    hooks are compiled out and the reports are empty.
+*/
+#ifndef CS_PROFILE_SLOTS
+#   define CS_PROFILE_SLOTS 1024
+#endif
+
+// a profiled call site, see CS_PROFILE
+struct profile_entry {
+    const char* file;
+    uint32_t line;
+    uint64_t label;     // hash of the encrypted data
+    uint64_t calls;
+    uint64_t ticks;
+};
+
+namespace detail {
+
+// source location of a cs::crypt call, filled in through default arguments
+struct call_site {
+#if defined(CS_PROFILE)
+    const char* file;
+    uint32_t line;
+
+    static constexpr call_site current( const char* _file = __builtin_FILE(), uint32_t _line = __builtin_LINE() ) noexcept {
+        return call_site{_file, _line};
+    }
+#else
+    static constexpr call_site current() noexcept {
+        return call_site{};
+    }
+#endif
+};
+
+#if defined(CS_PROFILE)
+// compile-time tag of a cryptstr, key 0 is never used for a tagged site
+struct site_tag {
+    uint64_t key;
+    const char* file;
+    uint32_t line;
+    uint64_t label;
+};
+
+template < class CharType, size_t N >
+constexpr site_tag make_site_tag( const call_site& _site, const ctstr<CharType,N>& _data ) noexcept {
+    uint64_t label = UINT64_C(0xcbf29ce484222325);
+    for ( size_t i = 0; N > i; ++i ) {
+        label = (label ^ static_cast<uint64_t>(_data[i])) * UINT64_C(0x100000001b3);
+    }
+    const uint64_t key = splitmix64(fnv1a(_site.file) ^ static_cast<uint64_t>(_site.line) << 32 ^ label);
+    return site_tag{key ? key : 1, _site.file, _site.line, label};
+}
+
+// one slot of the profiling table, claimed by the first site that hashes to it.
+// The tag is copied, cryptstr instances with automatic storage may be gone when the table is read.
+// file is stored last and marks the slot as readable.
+struct alignas(64) profile_slot {
+    std::atomic<uint64_t> key{0};
+    std::atomic<const char*> file{nullptr};
+    std::atomic<uint32_t> line{0};
+    std::atomic<uint64_t> label{0};
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> ticks{0};
+};
+
+struct profile_table {
+    profile_slot slots[CS_PROFILE_SLOTS];
+    std::atomic<uint64_t> dropped{0};   // calls of sites that found the table full
+};
+
+inline profile_table& profile_slots() noexcept {
+    static profile_table table;
+    return table;
+}
+
+inline uint64_t profile_ticks() noexcept {
+#if defined(CS_X86) && (defined(CS_GCC) || defined(CS_CLANG))
+    return __builtin_ia32_rdtsc();
+#elif defined(CS_X86) && defined(CS_MSVC)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// adds a call of _tag to its slot, probing linearly from the key's home slot
+inline void profile_record( const site_tag& _tag, uint64_t _ticks ) noexcept {
+    profile_table& table = profile_slots();
+    for ( size_t i = 0; CS_PROFILE_SLOTS > i; ++i ) {
+        profile_slot& slot = table.slots[(_tag.key + i) % CS_PROFILE_SLOTS];
+        uint64_t key = slot.key.load(std::memory_order_acquire);
+        if ( key == 0 && slot.key.compare_exchange_strong(key, _tag.key, std::memory_order_acq_rel) ) {
+            slot.line.store(_tag.line, std::memory_order_relaxed);
+            slot.label.store(_tag.label, std::memory_order_relaxed);
+            slot.file.store(_tag.file, std::memory_order_release);
+            key = _tag.key;
+        }
+        if ( key == _tag.key ) {
+            slot.calls.fetch_add(1, std::memory_order_relaxed);
+            slot.ticks.fetch_add(_ticks, std::memory_order_relaxed);
+            return;
+        }
+    }
+    table.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+// records the ticks between construction and destruction for a site
+struct profile_scope {
+    const site_tag& tag;
+    uint64_t start;
+
+    explicit profile_scope( const site_tag& _tag ) noexcept : tag(_tag), start(profile_ticks()) {}
+    ~profile_scope() {
+        profile_record(tag, profile_ticks() - start);
+    }
+    profile_scope( const profile_scope& ) = delete;
+    profile_scope& operator = ( const profile_scope& ) = delete;
+};
+#endif
+
+}
+
+// returns up to _top sites with the most ticks, in descending order
+inline std::vector<profile_entry> profile_sites( size_t _top = static_cast<size_t>(-1) ) {
+    std::vector<profile_entry> result;
+#if defined(CS_PROFILE)
+    detail::profile_table& table = detail::profile_slots();
+    for ( size_t i = 0; CS_PROFILE_SLOTS > i; ++i ) {
+        const detail::profile_slot& slot = table.slots[i];
+        const char* file = slot.file.load(std::memory_order_acquire);
+        if ( !file )
+            continue;
+        result.push_back(profile_entry{file, slot.line.load(std::memory_order_relaxed), slot.label.load(std::memory_order_relaxed), slot.calls.load(std::memory_order_relaxed),
+            slot.ticks.load(std::memory_order_relaxed)});
+    }
+    std::sort(result.begin(), result.end(), []( const profile_entry& _a, const profile_entry& _b ) {
+        return _a.ticks > _b.ticks;
+    });
+    if ( result.size() > _top )
+        result.resize(_top);
+#else
+    (void)_top;
+#endif
+    return result;
+}
+
+// writes the top _top sites to _out, one line per site: ticks, calls, ticks per call, label and location
+inline void profile_dump( std::FILE* _out = stderr, size_t _top = 20 ) {
+    const std::vector<profile_entry> sites = profile_sites(_top);
+    std::fprintf(_out, "%16s %12s %10s %16s  %s\n", "ticks", "calls", "per call", "label", "site");
+    for ( const profile_entry& entry : sites ) {
+        std::fprintf(_out, "%16llu %12llu %10llu %016llx  %s:%u\n", static_cast<unsigned long long>(entry.ticks),
+            static_cast<unsigned long long>(entry.calls),
+            static_cast<unsigned long long>(entry.calls ? entry.ticks / entry.calls : 0),
+            static_cast<unsigned long long>(entry.label), entry.file, entry.line);
+    }
+#if defined(CS_PROFILE)
+    const uint64_t dropped = detail::profile_slots().dropped.load(std::memory_order_relaxed);
+    if ( dropped )
+        std::fprintf(_out, "%llu calls not recorded, raise CS_PROFILE_SLOTS\n", static_cast<unsigned long long>(dropped));
+#endif
+}
+
+#if defined(CS_PROFILE)
+#   define CS_PROFILE_SCOPE(tag) const ::cs::detail::profile_scope cs_profile_scope(tag)
+#else
+#   define CS_PROFILE_SCOPE(tag) ((void)0)
+#endif
+
+template < class CharType, size_t N, class Functor >
+struct cryptstr;
+template < class CharType >
+struct strview;
+
+namespace detail {
+// creates zeroed strview instances for containers that decrypt into them
+struct view_access {
+    template < class CharType >
+    static strview<CharType> make( size_t _size ) {
+        return strview<CharType>(_size);
+    }
+};
+}
+
+// A view into an obfuscated_string instance.
+// Automatically zeroes all bytes on destruction of the object.
+// strview can only be passed by reference or pointer.
+// zero<> is the first base, so it wipes the object only after std::basic_string released its buffer.
 template < class CharType >
-struct strview : std::basic_string<CharType>, zero<strview<CharType>> {
+struct strview : zero<strview<CharType>>, std::basic_string<CharType> {
     typedef CharType char_type;
 
     // Disallowed Behavior
@@ -381,15 +2038,279 @@ struct strview : std::basic_string<CharType>, zero<strview<CharType>> {
 
     // only allowed constructor is from a ctstr instance
     template < size_t N >
-    strview( const ctstr<char_type,N>& _str) : std::basic_string<char_type>(_str.get(), _str.size()) {}
+    strview( const ctstr<char_type,N>& _str) : std::basic_string<char_type>(_str.get(), _str.size()) {
+        CS_STATS(detail::stats_view(true, N * sizeof(char_type)));
+    }
 
-    // default move behavior
-    strview(strview&&) = default;
+    // default move behavior, the moved-from instance is left empty and the bytes move with the buffer
+    strview( strview&& _other ) : zero<strview<CharType>>(), std::basic_string<char_type>(std::move(_other)) {
+        CS_STATS(detail::stats_view(true, 0));
+    }
 
     // duplicate std::string operator and construction behavior
     ~strview() {
+        CS_STATS(detail::stats_view(false, this->size() * sizeof(CharType)));
         memzero((void*)this->c_str(), this->size() * sizeof(CharType));
     }
+
+private:
+    template < class, size_t, class > friend struct cryptstr;
+    friend struct detail::view_access;
+
+    // construct a zeroed view of _size elements, which cryptstr decrypts into
+    explicit strview( size_t _size ) : std::basic_string<char_type>(_size, char_type()) {
+        CS_STATS(detail::stats_view(true, _size * sizeof(char_type)));
+    }
+};
+
+// A fixed-capacity view into an obfuscated_string instance.
+// The N elements live in an inline array, no heap memory is ever involved.
+// Automatically zeroes all elements on destruction of the object.
+// static_strview can only be passed by reference or pointer.
+template < class CharType, size_t N >
+struct static_strview : zero<static_strview<CharType,N>> {
+    typedef CharType char_type;
+    typedef std::basic_string_view<CharType> view_type;
+    typedef const CharType* const_iterator;
+    static constexpr size_t ct_size = N;
+
+    // Disallowed Behavior
+
+    // copying or moving static_strview instances should not be possible. decrypt_static()
+    // returns a prvalue, so no copy or move is needed to receive one.
+    static_strview( const static_strview& ) = delete;
+    static_strview& operator = ( const static_strview& ) = delete;
+    static_strview( static_strview&& ) = delete;
+    static_strview& operator = ( static_strview&& ) = delete;
+
+    // no implicit conversion to std::basic_string
+    operator std::basic_string<CharType> () const = delete;
+
+    // Allowed Behavior
+
+    // only allowed constructor is from a cryptstr instance
+    template < class Functor >
+    explicit static_strview( const cryptstr<char_type,N,Functor>& _src ) {
+        _src.decrypt_into(&str[0], N);
+        str[N] = char_type();
+    }
+
+    // read accessors, c_str() is always null-terminated
+    const char_type* data() const noexcept { return &str[0]; }
+    const char_type* c_str() const noexcept { return &str[0]; }
+    constexpr size_t size() const noexcept { return N; }
+    constexpr size_t length() const noexcept { return N; }
+    constexpr bool empty() const noexcept { return N == 0; }
+
+    const char_type& operator [] ( size_t _index ) const noexcept { return str[_index]; }
+    const char_type& at( size_t _index ) const {
+        return ( _index < N ) ? str[_index] : throw std::out_of_range("index out of range");
+    }
+    const char_type& front() const noexcept { return str[0]; }
+    const char_type& back() const noexcept { return str[N - 1]; }
+
+    const_iterator begin() const noexcept { return &str[0]; }
+    const_iterator end() const noexcept { return &str[N]; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // non-owning view, must not outlive *this
+    view_type view() const noexcept { return view_type(&str[0], N); }
+    operator view_type () const noexcept { return view(); }
+
+    // ~zero wipes all elements including the terminator
+private:
+    char_type str[N + 1];
+};
+template < class CharType, class Traits, size_t N >
+std::basic_ostream<CharType,Traits>& operator << ( std::basic_ostream<CharType,Traits>& _os, const static_strview<CharType,N>& _str ) {
+    return _os << _str.view();
+}
+
+/**
+    CS_STREAM_CHUNK
+
+    Size in bytes of the stack buffer used by decrypt_to(). Every chunk is decrypted, written to the
+    sink and overwritten by the next one, the buffer is wiped afterwards. The default keeps the
+    buffer L1-resident.
+*/
+#ifndef CS_STREAM_CHUNK
+#   define CS_STREAM_CHUNK 1024
+#endif
+
+// A file descriptor sink for decrypt_to, written with write(2)
+struct fd_sink {
+    int fd;
+};
+
+namespace detail {
+
+// writes _len elements to a std::basic_ostream, std::FILE*, cs::fd_sink or callable sink
+// \return false if the sink failed
+template < class CharType, class Sink >
+bool sink_write(Sink& _sink, const CharType* _str, size_t _len) {
+    typedef typename std::remove_cv<Sink>::type sink_type;
+    if constexpr ( std::is_same<sink_type, std::FILE*>::value ) {
+        return std::fwrite(_str, sizeof(CharType), _len, _sink) == _len;
+    } else if constexpr ( std::is_same<sink_type, fd_sink>::value ) {
+        const char* bytes = reinterpret_cast<const char*>(_str);
+        size_t remaining = _len * sizeof(CharType);
+        while ( remaining > 0 ) {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+            const int chunk = remaining > 0x40000000 ? 0x40000000 : static_cast<int>(remaining);
+            const int written = ::_write(_sink.fd, bytes, static_cast<unsigned>(chunk));
+#else
+            const ssize_t written = ::write(_sink.fd, bytes, remaining);
+#endif
+            if ( written < 0 ) {
+                if ( errno == EINTR )
+                    continue;
+                return false;
+            }
+            bytes += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        return true;
+    } else if constexpr ( std::is_invocable<Sink&, const CharType*, size_t>::value ) {
+        if constexpr ( std::is_convertible<std::invoke_result_t<Sink&, const CharType*, size_t>, bool>::value ) {
+            return static_cast<bool>(_sink(_str, _len));
+        } else {
+            _sink(_str, _len);
+            return true;
+        }
+    } else {
+        // byte data, e.g. blobs of unsigned char, is written to narrow streams as is
+        typedef typename sink_type::char_type stream_char;
+        static_assert(sizeof(stream_char) == sizeof(CharType), "stream and string element sizes differ");
+        _sink.write(reinterpret_cast<const stream_char*>(_str), static_cast<std::streamsize>(_len));
+        return static_cast<bool>(_sink);
+    }
+}
+
+// stack buffer of decrypt_stream, wiped on destruction, also if the sink throws
+template < class CharType >
+struct stream_chunk : zero<stream_chunk<CharType>> {
+    static constexpr size_t capacity = CS_STREAM_CHUNK / sizeof(CharType) > 0 ? CS_STREAM_CHUNK / sizeof(CharType) : 1;
+    CharType values[capacity];
+};
+
+// decrypts _count elements of the _len elements long _src, starting at _offset, chunk by chunk into
+// _sink. At most one chunk of plaintext exists at any time.
+// \return number of written elements, less than _count if the sink failed
+template < class CharType, class Functor, class Sink >
+size_t decrypt_stream(const Functor& _functor, const CharType* _src, size_t _len, size_t _offset, size_t _count, Sink& _sink) {
+    Functor f = _functor;
+    const CharType* src = opaque(_src);
+    stream_chunk<CharType> chunk;
+    size_t written = 0;
+    while ( _count > written ) {
+        const size_t num = ( _count - written < chunk.capacity ) ? _count - written : chunk.capacity;
+        apply_functor(f, src, _len, &chunk.values[0], _offset + written, num);
+        if ( !sink_write(_sink, &chunk.values[0], num) )
+            break;
+        written += num;
+    }
+    CS_STATS(stats_decrypt(written * sizeof(CharType)));
+    return written;
+}
+
+}
+
+namespace detail {
+
+// decrypts _count elements of the _len elements long _src, starting at _offset, into _dst
+// \return number of written elements
+template < class CharType, class Functor >
+size_t decrypt_range(const Functor& _functor, const CharType* _src, size_t _len, size_t _offset, size_t _count, CharType* _dst) {
+    if ( _offset > _len || _count > _len - _offset )
+        throw std::out_of_range("range out of bounds");
+    Functor f = _functor;
+    apply_functor(f, opaque(_src), _len, _dst, _offset, _count);
+    CS_STATS(stats_decrypt(_count * sizeof(CharType)));
+    return _count;
+}
+
+}
+
+/* crypt_cursor
+    reads a crypted string sequentially or at random positions, decrypting lazily.
+    Only a window of 64 elements around the current position is held in plaintext, it is wiped
+    when the cursor moves past it and on destruction. The crypted source has to outlive the cursor.
+*/
+template < class CharType, class Functor >
+struct crypt_cursor : zero<crypt_cursor<CharType,Functor>> {
+    typedef CharType char_type;
+    typedef Functor functor_type;
+
+    static constexpr size_t window_size = 64;
+
+    // \param _functor Functor object that was used to crypt _src
+    // \param _src crypted elements
+    // \param _len number of elements of _src
+    crypt_cursor( const functor_type& _functor, const char_type* _src, size_t _len ) noexcept
+        : functor(_functor), src(_src), len(_len), pos(0), window_begin(0), window_end(0) {}
+    crypt_cursor( const crypt_cursor& ) = delete;
+    crypt_cursor& operator = ( const crypt_cursor& ) = delete;
+
+    // number of elements of the crypted source
+    size_t size() const noexcept { return len; }
+    // current position
+    size_t tell() const noexcept { return pos; }
+    // true if the position is at the end
+    bool eof() const noexcept { return pos >= len; }
+
+    // moves to _pos, which may be size()
+    void seek( size_t _pos ) {
+        if ( _pos > len )
+            throw std::out_of_range("position out of bounds");
+        pos = _pos;
+    }
+    // moves by _count elements, at most to the end
+    void skip( size_t _count ) noexcept {
+        pos = ( _count > len - pos ) ? len : pos + _count;
+    }
+
+    // element at the current position, throws std::out_of_range at the end
+    char_type peek() {
+        if ( eof() )
+            throw std::out_of_range("cursor at end");
+        if ( pos < window_begin || pos >= window_end )
+            fill(pos);
+        return window[pos - window_begin];
+    }
+    // element at the current position, advances by one
+    char_type next() {
+        const char_type value = peek();
+        ++pos;
+        return value;
+    }
+
+    // decrypts up to _count elements from the current position straight into _dst and advances
+    // \return number of written elements, less than _count at the end
+    size_t read( char_type* _dst, size_t _count ) {
+        const size_t num = ( _count > len - pos ) ? len - pos : _count;
+        detail::decrypt_range(functor, src, len, pos, num, _dst);
+        pos += num;
+        return num;
+    }
+
+private:
+    // decrypts the window containing _pos, windows start at multiples of window_size
+    void fill( size_t _pos ) {
+        window_begin = _pos - _pos % window_size;
+        window_end = ( len - window_begin > window_size ) ? window_begin + window_size : len;
+        detail::decrypt_range(functor, src, len, window_begin, window_end - window_begin, &window[0]);
+        if ( window_end - window_begin < window_size )
+            this->set_zero(&window[window_end - window_begin], sizeof(char_type) * (window_size - (window_end - window_begin)));
+    }
+
+    functor_type functor;
+    const char_type* src;
+    size_t len;
+    size_t pos;
+    size_t window_begin;
+    size_t window_end;
+    char_type window[window_size];
 };
 
 // A obfuscated string instance which can only be read via a
@@ -402,9 +2323,16 @@ struct cryptstr {
     // construct a cryptstr instance from another one, allowing nested processing of ctstr instances
     // \param _functor Functor object that was used to transform _other
     // \param _other crypted compile-time string instance
+    // \param _site source location the instance is tagged with if CS_PROFILE is defined
     template < size_t Y >
-    constexpr cryptstr(functor_type _functor, const ctstr<char_type,Y>& _other ) noexcept : data(_other), functor(_functor) {
+    constexpr cryptstr(functor_type _functor, const ctstr<char_type,Y>& _other,
+        detail::call_site _site = detail::call_site::current() ) noexcept : functor(_functor), data(_other)
+#if defined(CS_PROFILE)
+        , site(detail::make_site_tag(_site, _other))
+#endif
+    {
         static_assert(Y == N, "invalid sizes");
+        (void)_site;
     }
 
     // returns the string's size
@@ -417,24 +2345,102 @@ struct cryptstr {
 
     // returns an unobfuscated string instance
     strview<CharType> decrypt() const {
-        auto raw = transform(data, functor);
-        strview<CharType> view(raw);
-        memzero( (void*)const_cast<CharType*>(raw.get()), sizeof(CharType) * N);
+        strview<CharType> view(N);
+        decrypt_into(&view[0], view.size());
         return view;
     }
 
+    // decrypts all N elements straight into caller memory, without temporaries or allocations.
+    // The caller is responsible for wiping _dst.
+    // \param _dst destination buffer
+    // \param _cap capacity of _dst in elements, has to be at least size()
+    // \return number of written elements
+    size_t decrypt_into( char_type* _dst, size_t _cap ) const {
+        CS_PROFILE_SCOPE(site);
+#if defined(CS_SHARED_KERNEL)
+        detail::decrypt_kernel(functor, data.get(), N, _dst, _cap);
+#else
+        if ( _cap < N )
+            throw std::length_error("destination too small");
+        functor_type f = functor;
+        detail::apply_functor(f, detail::opaque(data.get()), N, _dst, 0, N);
+#endif
+        CS_STATS(detail::stats_decrypt(N * sizeof(char_type)));
+        return N;
+    }
+    template < size_t Y >
+    size_t decrypt_into( char_type (&_dst)[Y] ) const {
+        static_assert(Y >= N, "destination too small");
+        return decrypt_into(&_dst[0], Y);
+    }
+#if defined(__cpp_lib_span)
+    size_t decrypt_into( std::span<char_type> _dst ) const {
+        return decrypt_into(_dst.data(), _dst.size());
+    }
+#endif
+
+    // compares a runtime string with the plaintext without decrypting it. The input is encrypted with
+    // the functor and compared with the stored data in constant time, no plaintext copy is created.
+    // The input may omit the terminating null element of the crypted literal.
+    bool equals( const char_type* _str, size_t _len ) const {
+        functor_type f = functor;
+        if constexpr ( detail::has_apply_block<Functor,CharType>::value ) {
+            return detail::encrypted_equals(f, data.get(), N, _str, _len, static_cast<char_type*>(nullptr));
+        } else {
+            char_type scratch[N];
+            return detail::encrypted_equals(f, data.get(), N, _str, _len, &scratch[0]);
+        }
+    }
+    bool equals( std::basic_string_view<char_type> _str ) const {
+        return equals(_str.data(), _str.size());
+    }
+
+    // decrypts the string chunk by chunk into a wiped stack buffer of CS_STREAM_CHUNK bytes and writes
+    // every chunk to _sink, without the terminating null element. The whole plaintext never exists at once.
+    // \param _sink std::basic_ostream, std::FILE*, cs::fd_sink or a callable taking (const char_type*, size_t),
+    //  which may return false on failure
+    // \return number of written elements, less than size() - 1 if the sink failed
+    template < class Sink >
+    size_t decrypt_to( Sink&& _sink ) const {
+        CS_PROFILE_SCOPE(site);
+        return detail::decrypt_stream(functor, data.get(), N, 0, N - 1, _sink);
+    }
+
+    // decrypts _count elements starting at _offset into _dst, the rest of the string stays encrypted.
+    // Throws std::out_of_range if the range exceeds size(). The caller is responsible for wiping _dst.
+    // \return number of written elements
+    size_t decrypt_range( size_t _offset, size_t _count, char_type* _dst ) const {
+        CS_PROFILE_SCOPE(site);
+        return detail::decrypt_range(functor, data.get(), N, _offset, _count, _dst);
+    }
+
+    // returns a cursor that decrypts the string lazily on access, see crypt_cursor
+    crypt_cursor<CharType,Functor> cursor() const noexcept {
+        return crypt_cursor<CharType,Functor>(functor, data.get(), N);
+    }
+
+    // returns an unobfuscated string instance with inline storage, without any allocation
+    static_strview<CharType,N> decrypt_static() const {
+        return static_strview<CharType,N>(*this);
+    }
+
 public:
     Functor functor;
     const ctstr<char_type,N> data;
+#if defined(CS_PROFILE)
+    const detail::site_tag site;
+#endif
 };
-// constructs a cryptstr from an uncrypted source
+// constructs a cryptstr from an uncrypted source, _site is the caller's location
 template < class CharType, size_t N, class Functor >
-constexpr cryptstr<CharType,N,Functor> crypt(Functor _functor, const ctstr<CharType,N>& _other) {
-    return cryptstr<CharType, N, Functor>(_functor, transform(_other, _functor) );
+constexpr cryptstr<CharType,N,Functor> crypt(Functor _functor, const ctstr<CharType,N>& _other,
+    detail::call_site _site = detail::call_site::current()) {
+    return cryptstr<CharType, N, Functor>(_functor, transform(_other, _functor), _site);
 }
 template < class CharType, size_t N, class Functor >
-constexpr cryptstr<CharType,N,Functor> crypt(Functor _functor, const CharType (&_str)[N] ) {
-    return cryptstr<CharType,N,Functor>(_functor, transform(_str, _functor));
+constexpr cryptstr<CharType,N,Functor> crypt(Functor _functor, const CharType (&_str)[N],
+    detail::call_site _site = detail::call_site::current() ) {
+    return cryptstr<CharType,N,Functor>(_functor, transform(_str, _functor), _site);
 }
 
 }
@@ -0,0 +1,189 @@
+#pragma once
+
+// global includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+#if defined(__has_include)
+#   if __has_include(<memory_resource>)
+#       include <memory_resource>
+#       define CS_HAS_PMR
+#   endif
+#endif
+
+// local includes
+#include "cryptstr.hpp"
+
+namespace cs {
+
+// A bump-pointer arena for decrypted plaintext.
+// Allocation is a pointer bump without locking, deallocation is a no-op. reset() and the destructor
+// wipe the used extent with a single cs::memzero, instead of one wipe per buffer. Intended for
+// request-scoped work by a single thread, an arena must not be shared between threads.
+//
+//     cs::secure_arena arena(4096);
+//     std::string_view user = cs::decrypt(crypted_user, arena);
+//     std::string_view pass = cs::decrypt(crypted_pass, arena);
+//     ...
+//     arena.reset();  // both plaintexts wiped at once
+struct secure_arena {
+    static constexpr size_t alignment = 64;
+
+    // allocates _capacity bytes of 64 byte aligned storage, throws std::bad_alloc
+    explicit secure_arena( size_t _capacity )
+        : base(static_cast<unsigned char*>(::operator new(_capacity, std::align_val_t(alignment)))),
+          cap(_capacity), top(0), peak(0), owned(true) {}
+    // uses caller storage of _size bytes, e.g. a stack buffer or locked pages, which has to outlive the arena
+    secure_arena( void* _buffer, size_t _size ) noexcept
+        : base(static_cast<unsigned char*>(_buffer)), cap(_size), top(0), peak(0), owned(false) {}
+
+    // no copies, the arena owns its plaintext
+    secure_arena( const secure_arena& ) = delete;
+    secure_arena& operator = ( const secure_arena& ) = delete;
+
+    ~secure_arena() {
+        reset();
+        if ( owned )
+            ::operator delete(base, std::align_val_t(alignment));
+    }
+
+    // returns _bytes of storage aligned to _align, a power of two. Throws std::bad_alloc if the arena is exhausted.
+    void* allocate( size_t _bytes, size_t _align = alignof(std::max_align_t) ) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(base) + top;
+        const size_t padding = static_cast<size_t>((_align - (address & (_align - 1))) & (_align - 1));
+        if ( padding > cap - top || _bytes > cap - top - padding )
+            throw std::bad_alloc();
+        void* ptr = base + top + padding;
+        top += padding + _bytes;
+        return ptr;
+    }
+    template < class T >
+    T* allocate_array( size_t _count ) {
+        if ( _count > cap / sizeof(T) )
+            throw std::bad_alloc();
+        return static_cast<T*>(allocate(sizeof(T) * _count, alignof(T)));
+    }
+
+    // wipes everything allocated since the last reset with one bulk operation, invalidates all allocations
+    void reset() noexcept {
+        rewind(0);
+    }
+
+    // wipes and releases everything allocated after used() returned _mark, see arena_scope
+    void rewind( size_t _mark ) noexcept {
+        if ( top > _mark ) {
+            memzero(base + _mark, top - _mark);
+            peak = ( top > peak ) ? top : peak;
+            top = _mark;
+        }
+    }
+
+    // statistics
+    size_t capacity() const noexcept { return cap; }
+    size_t used() const noexcept { return top; }
+    size_t remaining() const noexcept { return cap - top; }
+    // largest extent used before a reset, for sizing the arena
+    size_t high_water() const noexcept { return ( top > peak ) ? top : peak; }
+
+private:
+    unsigned char* base;
+    size_t cap;
+    size_t top;
+    size_t peak;
+    bool owned;
+};
+
+// wipes and releases everything allocated from an arena during its lifetime with one cs::memzero
+//
+//     cs::arena_scope scope(arena);
+//     const auto keys = cs::decrypt_batch(arena, crypted_user, crypted_pass);
+struct arena_scope {
+    explicit arena_scope( secure_arena& _arena ) noexcept : arena(_arena), mark(_arena.used()) {}
+    ~arena_scope() {
+        arena.rewind(mark);
+    }
+
+    arena_scope( const arena_scope& ) = delete;
+    arena_scope& operator = ( const arena_scope& ) = delete;
+
+private:
+    secure_arena& arena;
+    const size_t mark;
+};
+
+// std-compatible allocator handing out arena memory, deallocate is a no-op
+template < class T >
+struct arena_allocator {
+    typedef T value_type;
+
+    explicit arena_allocator( secure_arena& _arena ) noexcept : arena(&_arena) {}
+    template < class U >
+    arena_allocator( const arena_allocator<U>& _other ) noexcept : arena(_other.arena) {}
+
+    T* allocate( size_t _count ) {
+        return arena->template allocate_array<T>(_count);
+    }
+    void deallocate( T*, size_t ) noexcept {}
+
+    template < class U >
+    bool operator == ( const arena_allocator<U>& _other ) const noexcept { return arena == _other.arena; }
+    template < class U >
+    bool operator != ( const arena_allocator<U>& _other ) const noexcept { return arena != _other.arena; }
+
+    secure_arena* arena;
+};
+
+#if defined(CS_HAS_PMR)
+// std::pmr::memory_resource over an arena, for std::pmr containers
+struct arena_resource : std::pmr::memory_resource {
+    explicit arena_resource( secure_arena& _arena ) noexcept : arena(&_arena) {}
+
+private:
+    void* do_allocate( size_t _bytes, size_t _align ) override {
+        return arena->allocate(_bytes, _align);
+    }
+    void do_deallocate( void*, size_t, size_t ) override {}
+    bool do_is_equal( const std::pmr::memory_resource& _other ) const noexcept override {
+        const arena_resource* other = dynamic_cast<const arena_resource*>(&_other);
+        return other && other->arena == arena;
+    }
+
+    secure_arena* arena;
+};
+#endif
+
+// decrypts all N elements of _crypted into the arena, followed by a null element.
+// The view stays valid until the arena is reset or destroyed, which also wipes it.
+template < class CharType, size_t N, class Functor >
+std::basic_string_view<CharType> decrypt( const cryptstr<CharType,N,Functor>& _crypted, secure_arena& _arena ) {
+    CharType* dst = _arena.allocate_array<CharType>(N + 1);
+    _crypted.decrypt_into(dst, N);
+    dst[N] = CharType();
+    return std::basic_string_view<CharType>(dst, N);
+}
+
+// decrypts all _crypted strings in one pass into a single contiguous arena allocation, each followed by
+// a null element. Saves the per-string allocation and wipe of decrypt(), the whole batch is wiped by one
+// cs::memzero when the arena is reset or rewound by an arena_scope.
+// Throws std::bad_alloc if the arena cannot hold all strings, nothing is allocated in that case.
+// \return views in argument order, each as cs::decrypt(crypted, arena) would return it
+template < class CharType, size_t... N, class... Functor >
+std::array<std::basic_string_view<CharType>, sizeof...(N)> decrypt_batch( secure_arena& _arena,
+    const cryptstr<CharType,N,Functor>&... _crypted ) {
+    CharType* dst = _arena.allocate_array<CharType>((size_t(0) + ... + (N + 1)));
+    std::array<std::basic_string_view<CharType>, sizeof...(N)> views;
+    size_t index = 0;
+    auto decrypt_one = [&]( const auto& _str ) {
+        const size_t size = _str.size();
+        _str.decrypt_into(dst, size);
+        dst[size] = CharType();
+        views[index++] = std::basic_string_view<CharType>(dst, size);
+        dst += size + 1;
+    };
+    (decrypt_one(_crypted), ...);
+    return views;
+}
+
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+// global includes
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#   if __has_include(<coroutine>)
+#       include <coroutine>
+#       define CS_HAS_COROUTINE
+#   endif
+#endif
+
+// local includes
+#include "cryptstr.hpp"
+#include "cryptstr_blob.hpp"
+
+namespace cs {
+
+/**
+    CS_ASYNC_THREADS
+
+    Number of worker threads of the shared pool behind cs::pool_executor, default 2. The pool bounds
+    the threads decrypt_async and co_decrypt can occupy, bulk decrypts queue up instead of adding threads.
+*/
+#ifndef CS_ASYNC_THREADS
+#   define CS_ASYNC_THREADS 2
+#endif
+
+namespace detail {
+
+// type-erased move-only task
+struct pool_task {
+    virtual ~pool_task() = default;
+    virtual void run() = 0;
+};
+template < class Task >
+struct pool_task_impl : pool_task {
+    explicit pool_task_impl( Task&& _task ) : task(std::move(_task)) {}
+    void run() override {
+        task();
+    }
+    Task task;
+};
+
+}
+
+// A fixed number of worker threads over a FIFO queue of move-only tasks.
+// The destructor lets the workers finish all queued tasks and joins them, so no task outlives the pool.
+// Tasks posted while the pool shuts down run on the posting thread. Like with std::thread, an exception
+// escaping a task calls std::terminate, decrypt_async and co_decrypt never let one escape.
+struct thread_pool {
+    explicit thread_pool( unsigned _threads ) : stopping(false) {
+        if ( _threads == 0 )
+            _threads = 1;
+        workers.reserve(_threads);
+        try {
+            for ( unsigned i = 0; _threads > i; ++i ) {
+                workers.emplace_back([this] { run(); });
+            }
+        } catch ( ... ) {
+            shutdown();
+            throw;
+        }
+    }
+
+    thread_pool( const thread_pool& ) = delete;
+    thread_pool& operator = ( const thread_pool& ) = delete;
+
+    ~thread_pool() {
+        shutdown();
+    }
+
+    template < class Task >
+    void post( Task&& _task ) {
+        typedef typename std::decay<Task>::type task_type;
+        std::unique_ptr<detail::pool_task> task(new detail::pool_task_impl<task_type>(task_type(std::forward<Task>(_task))));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if ( !stopping ) {
+                queue.push_back(std::move(task));
+                ready.notify_one();
+                return;
+            }
+        }
+        task->run();
+    }
+
+    // number of worker threads
+    size_t size() const noexcept { return workers.size(); }
+
+private:
+    void run() {
+        for ( ;; ) {
+            std::unique_ptr<detail::pool_task> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this] { return stopping || !queue.empty(); });
+                if ( queue.empty() )
+                    return;
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            task->run();
+        }
+    }
+
+    void shutdown() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for ( std::thread& worker : workers ) {
+            if ( worker.joinable() )
+                worker.join();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::unique_ptr<detail::pool_task>> queue;
+    bool stopping;
+    std::vector<std::thread> workers;
+};
+
+namespace detail {
+
+// shared pool of CS_ASYNC_THREADS workers, created on first use and joined during static destruction
+inline thread_pool& shared_pool() {
+    static thread_pool pool(CS_ASYNC_THREADS);
+    return pool;
+}
+
+}
+
+// Posts tasks to a thread_pool, by default the shared pool of CS_ASYNC_THREADS workers. This is the
+// default executor of decrypt_async and co_decrypt. An executor is any callable taking a move-only
+// void() task, e.g. one posting to an event loop:
+//
+//     auto on_loop = [&loop]( auto&& _task ) { loop.post(std::move(_task)); };
+//     auto future = cs::decrypt_async(crypted, on_loop);
+struct pool_executor {
+    pool_executor() : pool(&detail::shared_pool()) {}
+    explicit pool_executor( thread_pool& _pool ) noexcept : pool(&_pool) {}
+
+    template < class Task >
+    void operator () ( Task&& _task ) const {
+        pool->post(std::forward<Task>(_task));
+    }
+
+    thread_pool* pool;
+};
+
+// A move-only heap buffer of decrypted elements, wiped on destruction
+template < class T >
+struct secure_buffer {
+    typedef T value_type;
+
+    explicit secure_buffer( size_t _size ) : ptr(new T[_size]()), len(_size) {}
+
+    secure_buffer( secure_buffer&& _other ) noexcept : ptr(std::move(_other.ptr)), len(_other.len) {
+        _other.len = 0;
+    }
+    secure_buffer( const secure_buffer& ) = delete;
+    secure_buffer& operator = ( const secure_buffer& ) = delete;
+    secure_buffer& operator = ( secure_buffer&& ) = delete;
+
+    ~secure_buffer() {
+        if ( ptr )
+            memzero(ptr.get(), len * sizeof(T));
+    }
+
+    T* data() noexcept { return ptr.get(); }
+    const T* data() const noexcept { return ptr.get(); }
+    size_t size() const noexcept { return len; }
+    T& operator [] ( size_t _index ) noexcept { return ptr[_index]; }
+    const T& operator [] ( size_t _index ) const noexcept { return ptr[_index]; }
+    const T* begin() const noexcept { return ptr.get(); }
+    const T* end() const noexcept { return ptr.get() + len; }
+
+private:
+    std::unique_ptr<T[]> ptr;
+    size_t len;
+};
+
+namespace detail {
+
+// hands _work to _executor and returns the future of its result
+template < class Executor, class Work >
+std::future<decltype(std::declval<Work&>()())> submit( Executor&& _executor, Work _work ) {
+    typedef decltype(std::declval<Work&>()()) result_type;
+    std::packaged_task<result_type()> task(std::move(_work));
+    std::future<result_type> future = task.get_future();
+    _executor(std::move(task));
+    return future;
+}
+
+// decrypts a copy of a cryptstr, the task does not depend on the lifetime of the original
+template < class CharType, size_t N, class Functor >
+struct decrypt_str_work {
+    cryptstr<CharType,N,Functor> crypted;
+
+    strview<CharType> operator () () const {
+        return crypted.decrypt();
+    }
+};
+
+// decrypts a blob into a secure_buffer, the encrypted bytes have to outlive the task
+template < class Functor >
+struct decrypt_blob_work {
+    cryptblob<Functor> blob;
+
+    secure_buffer<unsigned char> operator () () const {
+        secure_buffer<unsigned char> buffer(blob.size());
+        blob.decrypt_into(buffer.data(), buffer.size());
+        return buffer;
+    }
+};
+
+}
+
+// decrypts _crypted on _executor, the calling thread does no decrypt work.
+// The future holds the strview, or the exception of a failed decrypt.
+template < class CharType, size_t N, class Functor, class Executor = pool_executor >
+std::future<strview<CharType>> decrypt_async( const cryptstr<CharType,N,Functor>& _crypted, Executor&& _executor = Executor() ) {
+    return detail::submit(std::forward<Executor>(_executor), detail::decrypt_str_work<CharType,N,Functor>{_crypted});
+}
+
+// decrypts all bytes of _blob into a secure_buffer on _executor
+template < class Functor, class Executor = pool_executor >
+std::future<secure_buffer<unsigned char>> decrypt_async( const cryptblob<Functor>& _blob, Executor&& _executor = Executor() ) {
+    return detail::submit(std::forward<Executor>(_executor), detail::decrypt_blob_work<Functor>{_blob});
+}
+
+#if defined(CS_HAS_COROUTINE)
+/* decrypt awaitable
+    Suspends the awaiting coroutine, runs the work on the executor and resumes the coroutine on the
+    executor's thread with the result. An executor that posts to an event loop resumes on the loop.
+    The awaitable lives in the coroutine frame, so the task refers to it without allocating.
+*/
+template < class Work, class Executor >
+struct decrypt_awaitable {
+    typedef decltype(std::declval<Work&>()()) result_type;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend( std::coroutine_handle<> _handle ) {
+        executor([this, _handle]() {
+            try {
+                result.emplace(work());
+            } catch ( ... ) {
+                error = std::current_exception();
+            }
+            _handle.resume();
+        });
+    }
+
+    result_type await_resume() {
+        if ( error )
+            std::rethrow_exception(error);
+        return std::move(*result);
+    }
+
+    Work work;
+    Executor executor;
+    std::optional<result_type> result;
+    std::exception_ptr error;
+};
+
+// co_await cs::co_decrypt(crypted) decrypts on _executor and yields the strview
+template < class CharType, size_t N, class Functor, class Executor = pool_executor >
+decrypt_awaitable<detail::decrypt_str_work<CharType,N,Functor>, std::decay_t<Executor>>
+co_decrypt( const cryptstr<CharType,N,Functor>& _crypted, Executor&& _executor = Executor() ) {
+    return { detail::decrypt_str_work<CharType,N,Functor>{_crypted}, std::forward<Executor>(_executor), {}, {} };
+}
+
+// co_await cs::co_decrypt(blob) decrypts on _executor and yields a secure_buffer
+template < class Functor, class Executor = pool_executor >
+decrypt_awaitable<detail::decrypt_blob_work<Functor>, std::decay_t<Executor>>
+co_decrypt( const cryptblob<Functor>& _blob, Executor&& _executor = Executor() ) {
+    return { detail::decrypt_blob_work<Functor>{_blob}, std::forward<Executor>(_executor), {}, {} };
+}
+#endif
+
+}
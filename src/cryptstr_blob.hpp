@@ -0,0 +1,81 @@
+#pragma once
+
+// global includes
+#include <cstddef>
+#include <stdexcept>
+
+// local includes
+#include "cryptstr.hpp"
+
+namespace cs {
+
+// An encrypted binary resource, e.g. a certificate, lookup table or WASM module.
+// cryptblob is a view of bytes that were encrypted at build time by tools/embed with a keystream
+// functor, so arbitrarily large files never pass through constant evaluation. The generated header
+// defines the crypted array and a constexpr cryptblob instance for it:
+//
+//     #include "certificate.hpp"   // generated by: embed certificate cert.der certificate.hpp
+//     resources::certificate.decrypt_to(cs::fd_sink{fd});
+//
+// The blob is decrypted on access only, in ranges, chunks or through a cursor. Nothing has to be
+// resident in plaintext as a whole.
+template < class Functor >
+struct cryptblob {
+    typedef unsigned char value_type;
+    typedef Functor functor_type;
+
+    // \param _functor keystream functor the bytes were encrypted with
+    // \param _data encrypted bytes, has to outlive the instance
+    // \param _size number of bytes
+    constexpr cryptblob( functor_type _functor, const value_type* _data, size_t _size ) noexcept
+        : functor(_functor), bytes(_data), len(_size) {}
+
+    // returns the number of bytes
+    constexpr size_t size() const noexcept { return len; }
+    constexpr bool empty() const noexcept { return len == 0; }
+
+    // returns the encrypted bytes
+    constexpr const value_type* data() const noexcept { return bytes; }
+
+    // decrypts all bytes into caller memory, the caller is responsible for wiping _dst
+    // \param _cap capacity of _dst, has to be at least size()
+    // \return number of written bytes
+    size_t decrypt_into( value_type* _dst, size_t _cap ) const {
+        if ( _cap < len )
+            throw std::length_error("destination too small");
+        return detail::decrypt_range(functor, bytes, len, 0, len, _dst);
+    }
+
+    // decrypts _count bytes starting at _offset, throws std::out_of_range if the range exceeds size()
+    // \return number of written bytes
+    size_t decrypt_range( size_t _offset, size_t _count, value_type* _dst ) const {
+        return detail::decrypt_range(functor, bytes, len, _offset, _count, _dst);
+    }
+
+    // streams all bytes to _sink in wiped CS_STREAM_CHUNK chunks, see cryptstr::decrypt_to
+    // \return number of written bytes, less than size() if the sink failed
+    template < class Sink >
+    size_t decrypt_to( Sink&& _sink ) const {
+        return detail::decrypt_stream(functor, bytes, len, 0, len, _sink);
+    }
+    // streams _count bytes starting at _offset, throws std::out_of_range if the range exceeds size()
+    template < class Sink >
+    size_t decrypt_to( Sink&& _sink, size_t _offset, size_t _count ) const {
+        if ( _offset > len || _count > len - _offset )
+            throw std::out_of_range("range out of bounds");
+        return detail::decrypt_stream(functor, bytes, len, _offset, _count, _sink);
+    }
+
+    // returns a cursor that decrypts the blob lazily on access
+    crypt_cursor<value_type,Functor> cursor() const noexcept {
+        return crypt_cursor<value_type,Functor>(functor, bytes, len);
+    }
+
+    Functor functor;
+
+private:
+    const value_type* bytes;
+    size_t len;
+};
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// global includes
+#include <atomic>
+#include <thread>
+#include <string_view>
+
+// local includes
+#include "cryptstr.hpp"
+
+namespace cs {
+
+// A decrypt-once cache around a cryptstr instance.
+// The first get() decrypts into an inline buffer and publishes it with release semantics, every later
+// get() is a single acquire load. Concurrent readers never lock, only readers racing the first
+// decryption yield until it is published.
+// The plaintext stays exposed until evict() or destruction wipes it. Declare instances static to
+// get a buffer that is wiped at exit.
+//
+// Build instances from a constexpr cryptstr, or declare them constinit in C++20, which rejects any
+// initializer that is not a constant expression. Only then is the string guaranteed to be encrypted at
+// compile time. An initializer that is not constant, e.g. a cs::crypt call with a non-constexpr functor,
+// is dynamically initialized at startup and may embed the plaintext literal:
+//
+//     static constexpr auto token = cs::crypt(functor, "X-Api-Token");
+//     static cs::cached_cryptstr header(token);
+//     std::string_view name = header.get();   // "X-Api-Token", without the terminator
+//
+//     constinit static cs::cached_cryptstr header(cs::crypt(functor, "X-Api-Token"));  // C++20
+template < class CharType, size_t N, class Functor >
+struct cached_cryptstr {
+    typedef CharType char_type;
+    typedef std::basic_string_view<CharType> view_type;
+    static_assert(N > 0, "cached strings hold at least the terminating null element");
+
+    // no copies of the plaintext buffer
+    cached_cryptstr( const cached_cryptstr& ) = delete;
+    cached_cryptstr& operator = ( const cached_cryptstr& ) = delete;
+
+    // constant-initialized when declared static with a constant expression, see above
+    constexpr cached_cryptstr( const cryptstr<CharType,N,Functor>& _crypted ) noexcept
+        : crypted(_crypted), state(empty), buffer{} {}
+
+    ~cached_cryptstr() {
+        memzero(buffer, sizeof(buffer));
+    }
+
+    // returns the plaintext without the terminating null element, decrypting it on first access.
+    // The view is valid until evict() is called or *this is destroyed, data() stays null terminated.
+    view_type get() {
+        if ( state.load(std::memory_order_acquire) != ready )
+            fill();
+        return view_type(buffer, N - 1);
+    }
+
+    // true if the plaintext is currently decrypted
+    bool cached() const noexcept {
+        return state.load(std::memory_order_acquire) == ready;
+    }
+
+    // wipes the plaintext, the next get() decrypts again.
+    // no reader may hold a view returned by get() while evict() runs.
+    void evict() noexcept {
+        for ( ;; ) {
+            unsigned expected = ready;
+            if ( state.compare_exchange_weak(expected, busy, std::memory_order_acquire) )
+                break;
+            if ( expected == empty )
+                return;
+            std::this_thread::yield();
+        }
+        memzero(buffer, sizeof(buffer));
+        state.store(empty, std::memory_order_release);
+    }
+
+    // returns the string's size
+    constexpr size_t size() const { return N; }
+
+private:
+    enum : unsigned { empty = 0, busy = 1, ready = 2 };
+
+    // slow path, only taken until the plaintext is published
+    CS_NOINLINE void fill() {
+        for ( ;; ) {
+            unsigned expected = empty;
+            if ( state.compare_exchange_weak(expected, busy, std::memory_order_acquire) ) {
+                try {
+                    crypted.decrypt_into(buffer, N);
+                } catch ( ... ) {
+                    memzero(buffer, sizeof(buffer));
+                    state.store(empty, std::memory_order_release);
+                    throw;
+                }
+                state.store(ready, std::memory_order_release);
+                return;
+            }
+            if ( expected == ready )
+                return;
+            std::this_thread::yield();
+        }
+    }
+
+    const cryptstr<CharType,N,Functor> crypted;
+    std::atomic<unsigned> state;
+    char_type buffer[N];
+};
+
+// constructs a cached_cryptstr from a cryptstr
+template < class CharType, size_t N, class Functor >
+constexpr cached_cryptstr<CharType,N,Functor> make_cached( const cryptstr<CharType,N,Functor>& _crypted ) noexcept {
+    return cached_cryptstr<CharType,N,Functor>(_crypted);
+}
+
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+// global includes
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+
+// local includes
+#include "cryptstr.hpp"
+
+namespace cs {
+namespace detail {
+
+// smallest power of two >= value
+constexpr size_t next_pow2( size_t value ) noexcept {
+    size_t result = 1;
+    while ( result < value ) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// splitmix64 finalizer
+constexpr uint64_t mix64( uint64_t value ) noexcept {
+    value ^= value >> 30;
+    value *= UINT64_C(0xbf58476d1ce4e5b9);
+    value ^= value >> 27;
+    value *= UINT64_C(0x94d049bb133111eb);
+    value ^= value >> 31;
+    return value;
+}
+
+// FNV-1a over all elements, followed by a finalizer for well distributed low bits
+template < class CharType >
+constexpr uint64_t dispatch_hash( const CharType* _str, size_t _len ) noexcept {
+    typedef typename std::make_unsigned<CharType>::type unsigned_type;
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    for ( size_t i = 0; _len > i; ++i ) {
+        hash ^= static_cast<uint64_t>(static_cast<unsigned_type>(_str[i]));
+        hash *= UINT64_C(0x100000001b3);
+    }
+    return mix64(hash);
+}
+
+// hash of the plaintext of a cryptstr without its terminating null element.
+// only meant for constant evaluation, the plaintext never reaches the binary.
+template < class CharType, size_t N, class Functor >
+constexpr uint64_t plaintext_hash( const cryptstr<CharType,N,Functor>& _key ) {
+    const auto plain = transform(_key.ct(), _key.functor);
+    size_t len = N;
+    if ( len > 0 && plain[len - 1] == CharType() )
+        --len;
+    return dispatch_hash(plain.get(), len);
+}
+
+}
+
+// A compile-time perfect hash over a set of cryptstr keys.
+// The constructor hashes the plaintext of every key during constant evaluation and builds a
+// hash-and-displace table: every key hash selects a bucket, and every bucket stores a seed that
+// moves its keys to distinct slots. Only the hashes' seeds, the slot table and the encrypted
+// keys are stored. find() hashes the input, checks the single candidate with the constant-time
+// cryptstr::equals and returns the index of the key in construction order.
+//
+// Building the table handles the plaintext keys, so it must only happen during constant evaluation.
+// With C++20 the constructor and make_dispatch are consteval, with C++17 always declare the result
+// constexpr. A table built at runtime would leave unwiped plaintext on the stack.
+//
+//     constexpr auto commands = cs::make_dispatch(cs::crypt(f, "get"), cs::crypt(f, "put"));
+//     switch ( commands.find(input) ) { case 0: ...; case 1: ...; default: ... }
+template < class... Keys >
+struct dispatch {
+    static_assert(sizeof...(Keys) > 0, "dispatch needs at least one key");
+    typedef typename std::tuple_element<0, std::tuple<Keys...>>::type::char_type char_type;
+    static_assert((std::is_same<char_type, typename Keys::char_type>::value && ...), "keys need the same char type");
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t key_count = sizeof...(Keys);
+    static constexpr size_t bucket_count = key_count;
+    static constexpr size_t slot_count = detail::next_pow2(2 * key_count);
+
+    // builds the table, fails to be a constant expression for duplicate keys
+    CS_CONSTEVAL dispatch( const Keys&... _keys ) : keys(_keys...), seeds{}, slots{} {
+        const uint64_t hashes[key_count] = { detail::plaintext_hash(_keys)... };
+        build(hashes);
+    }
+
+    // returns the index of the key equal to _str or npos.
+    // Like cryptstr::equals, _str may include or omit the terminating null element of the key.
+    size_t find( const char_type* _str, size_t _len ) const {
+        const size_t hashed = ( _len > 0 && _str[_len - 1] == char_type() ) ? _len - 1 : _len;
+        const uint64_t hash = detail::dispatch_hash(_str, hashed);
+        const size_t index = slots[slot(hash, seeds[bucket(hash)])];
+        if ( index >= key_count )
+            return npos;
+        return compare(index, _str, _len, std::index_sequence_for<Keys...>()) ? index : npos;
+    }
+    size_t find( std::basic_string_view<char_type> _str ) const {
+        return find(_str.data(), _str.size());
+    }
+
+    // number of keys
+    constexpr size_t size() const noexcept { return key_count; }
+
+private:
+    static constexpr size_t bucket( uint64_t _hash ) noexcept {
+        return static_cast<size_t>((_hash >> 32) % bucket_count);
+    }
+    static constexpr size_t slot( uint64_t _hash, uint32_t _seed ) noexcept {
+        return static_cast<size_t>(detail::mix64(_hash + _seed * UINT64_C(0x9e3779b97f4a7c15)) & (slot_count - 1));
+    }
+
+    // hash-and-displace: place the largest buckets first, search a seed per bucket
+    constexpr void build( const uint64_t (&_hashes)[key_count] ) {
+        for ( size_t i = 0; slot_count > i; ++i ) {
+            slots[i] = key_count;
+        }
+        for ( size_t i = 0; key_count > i; ++i ) {
+            for ( size_t j = i + 1; key_count > j; ++j ) {
+                if ( _hashes[i] == _hashes[j] )
+                    throw std::invalid_argument("duplicate dispatch keys");
+            }
+        }
+
+        size_t sizes[bucket_count] = {};
+        for ( size_t i = 0; key_count > i; ++i ) {
+            ++sizes[bucket(_hashes[i])];
+        }
+        bool placed[bucket_count] = {};
+        for ( size_t round = 0; bucket_count > round; ++round ) {
+            size_t current = 0;
+            for ( size_t b = 1; bucket_count > b; ++b ) {
+                if ( !placed[b] && ( placed[current] || sizes[b] > sizes[current] ) )
+                    current = b;
+            }
+            placed[current] = true;
+            if ( sizes[current] == 0 )
+                continue;
+            seeds[current] = find_seed(_hashes, current);
+            for ( size_t i = 0; key_count > i; ++i ) {
+                if ( bucket(_hashes[i]) == current )
+                    slots[slot(_hashes[i], seeds[current])] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    constexpr uint32_t find_seed( const uint64_t (&_hashes)[key_count], size_t _bucket ) const {
+        for ( uint32_t seed = 0; seed < (UINT32_C(1) << 20); ++seed ) {
+            bool valid = true;
+            for ( size_t i = 0; valid && key_count > i; ++i ) {
+                if ( bucket(_hashes[i]) != _bucket )
+                    continue;
+                const size_t target = slot(_hashes[i], seed);
+                valid = slots[target] == key_count;
+                for ( size_t j = 0; valid && i > j; ++j ) {
+                    valid = bucket(_hashes[j]) != _bucket || slot(_hashes[j], seed) != target;
+                }
+            }
+            if ( valid )
+                return seed;
+        }
+        throw std::logic_error("no perfect hash seed found");
+    }
+
+    template < size_t... I >
+    bool compare( size_t _index, const char_type* _str, size_t _len, std::index_sequence<I...> ) const {
+        return ( ( _index == I && std::get<I>(keys).equals(_str, _len) ) || ... );
+    }
+
+    const std::tuple<Keys...> keys;
+    uint32_t seeds[bucket_count];
+    uint32_t slots[slot_count];
+};
+
+// constructs a dispatch table from cryptstr keys, only during constant evaluation, see dispatch
+template < class... Keys >
+CS_CONSTEVAL dispatch<Keys...> make_dispatch( const Keys&... _keys ) {
+    return dispatch<Keys...>(_keys...);
+}
+
+}
@@ -0,0 +1,288 @@
+#pragma once
+
+// global includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/mman.h>
+#   include <unistd.h>
+#elif defined(_WIN32)
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#endif
+
+// local includes
+#include "cryptstr.hpp"
+
+namespace cs {
+
+// occupancy of a secure_page_pool, see secure_page_pool::stats()
+struct page_pool_stats {
+    static constexpr size_t class_count = 9;
+
+    struct size_class {
+        size_t slot_size;   // bytes per slot
+        size_t slots;       // number of slots
+        size_t in_use;      // slots currently allocated
+        size_t peak;        // largest in_use so far
+    };
+
+    size_t region_bytes;    // bytes reserved for all classes
+    bool locked;            // the region is locked into RAM
+    bool dontdump;          // the region is excluded from core dumps
+    size_t fallbacks;       // requests served from the heap, because they were too large or their class was full
+    size_class classes[class_count];
+};
+
+// A pool of locked pages for plaintext buffers.
+// One region is reserved on construction, locked into RAM with mlock and excluded from core dumps with
+// MADV_DONTDUMP, so plaintext never reaches swap or dumps. It is split into size classes of 16 to 4096
+// byte slots. Each class hands out slots through a lock-free free list, so the pool can be shared by all
+// threads. Requests above 4096 bytes or for an exhausted class fall back to the heap and are counted in
+// stats().fallbacks. If locking fails, e.g. due to RLIMIT_MEMLOCK, the pool still works and stats().locked
+// is false.
+//
+// deallocate() does not wipe, use page_pool_allocator, which wipes through zero_plugin_allocator, or
+// cs::memzero the slot before returning it.
+struct secure_page_pool {
+    static constexpr size_t class_count = page_pool_stats::class_count;
+    static constexpr size_t min_slot = 16;
+    static constexpr size_t max_slot = min_slot << (class_count - 1);
+
+    // reserves _class_bytes for every size class, rounded up to whole pages. Throws std::bad_alloc.
+    explicit secure_page_pool( size_t _class_bytes = 16384 ) : region(nullptr), region_bytes(0), class_bytes(0),
+        locked(false), dontdump(false), fallbacks(0) {
+        const size_t page = page_size();
+        class_bytes = ( (_class_bytes < max_slot ? max_slot : _class_bytes) + page - 1 ) / page * page;
+        region_bytes = class_bytes * class_count;
+        region = static_cast<unsigned char*>(map(region_bytes, locked, dontdump));
+
+        for ( size_t c = 0; class_count > c; ++c ) {
+            size_class& cls = classes[c];
+            cls.slot_size = min_slot << c;
+            cls.slots = class_bytes / cls.slot_size;
+            cls.next.reset(new std::atomic<uint32_t>[cls.slots]);
+            for ( size_t i = 0; cls.slots > i; ++i ) {
+                cls.next[i].store(( i + 1 < cls.slots ) ? static_cast<uint32_t>(i + 2) : 0, std::memory_order_relaxed);
+            }
+            cls.head.store(1, std::memory_order_release);
+        }
+    }
+
+    // the region holds plaintext, it is never copied or moved
+    secure_page_pool( const secure_page_pool& ) = delete;
+    secure_page_pool& operator = ( const secure_page_pool& ) = delete;
+
+    // wipes and releases the region, all slots have to be deallocated before
+    ~secure_page_pool() {
+        memzero(region, region_bytes);
+        unmap(region, region_bytes, locked);
+    }
+
+    // returns a slot of at least _bytes, aligned to its slot size
+    void* allocate( size_t _bytes ) {
+        if ( _bytes <= max_slot ) {
+            size_t c = 0;
+            while ( (min_slot << c) < _bytes ) {
+                ++c;
+            }
+            const uint32_t index = pop(classes[c]);
+            if ( index != 0 ) {
+                size_class& cls = classes[c];
+                const size_t used = cls.in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+                size_t peak = cls.peak.load(std::memory_order_relaxed);
+                while ( used > peak && !cls.peak.compare_exchange_weak(peak, used, std::memory_order_relaxed) ) {}
+                return region + c * class_bytes + (index - 1) * cls.slot_size;
+            }
+        }
+        fallbacks.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(_bytes);
+    }
+
+    // returns a slot or heap fallback of _bytes to the pool
+    void deallocate( void* _ptr, size_t _bytes ) noexcept {
+        (void)_bytes;
+        if ( !owns(_ptr) ) {
+            ::operator delete(_ptr);
+            return;
+        }
+        const size_t offset = static_cast<size_t>(static_cast<unsigned char*>(_ptr) - region);
+        size_class& cls = classes[offset / class_bytes];
+        push(cls, static_cast<uint32_t>((offset % class_bytes) / cls.slot_size + 1));
+        cls.in_use.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // true if _ptr points into the locked region
+    bool owns( const void* _ptr ) const noexcept {
+        const unsigned char* ptr = static_cast<const unsigned char*>(_ptr);
+        return std::less_equal<const unsigned char*>()(region, ptr) && std::less<const unsigned char*>()(ptr, region + region_bytes);
+    }
+
+    // snapshot of the occupancy, the counters are read without synchronizing with each other
+    page_pool_stats stats() const noexcept {
+        page_pool_stats result = {};
+        result.region_bytes = region_bytes;
+        result.locked = locked;
+        result.dontdump = dontdump;
+        result.fallbacks = fallbacks.load(std::memory_order_relaxed);
+        for ( size_t c = 0; class_count > c; ++c ) {
+            result.classes[c].slot_size = classes[c].slot_size;
+            result.classes[c].slots = classes[c].slots;
+            result.classes[c].in_use = classes[c].in_use.load(std::memory_order_relaxed);
+            result.classes[c].peak = classes[c].peak.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+private:
+    /* size class
+        Treiber stack of free slots. Links live outside the slots in next[], as 1-based indices
+        with 0 as end. head holds a 32 bit tag above the index, bumped on every change against ABA.
+    */
+    struct size_class {
+        std::atomic<uint64_t> head{0};
+        std::unique_ptr<std::atomic<uint32_t>[]> next;
+        size_t slot_size = 0;
+        size_t slots = 0;
+        std::atomic<size_t> in_use{0};
+        std::atomic<size_t> peak{0};
+    };
+
+    static uint32_t pop( size_class& _cls ) noexcept {
+        uint64_t head = _cls.head.load(std::memory_order_acquire);
+        for ( ;; ) {
+            const uint32_t index = static_cast<uint32_t>(head);
+            if ( index == 0 )
+                return 0;
+            const uint32_t next = _cls.next[index - 1].load(std::memory_order_relaxed);
+            const uint64_t desired = ((head >> 32) + 1) << 32 | next;
+            if ( _cls.head.compare_exchange_weak(head, desired, std::memory_order_acq_rel, std::memory_order_acquire) )
+                return index;
+        }
+    }
+
+    static void push( size_class& _cls, uint32_t _index ) noexcept {
+        uint64_t head = _cls.head.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            _cls.next[_index - 1].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            desired = ((head >> 32) + 1) << 32 | _index;
+        } while ( !_cls.head.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed) );
+    }
+
+    static size_t page_size() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        const long size = sysconf(_SC_PAGESIZE);
+        return size > 0 ? static_cast<size_t>(size) : 4096;
+#elif defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return 4096;
+#endif
+    }
+
+    static void* map( size_t _bytes, bool& _locked, bool& _dontdump ) {
+#if defined(__unix__) || defined(__APPLE__)
+        void* ptr = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if ( ptr == MAP_FAILED )
+            throw std::bad_alloc();
+        _locked = mlock(ptr, _bytes) == 0;
+#   if defined(MADV_DONTDUMP)
+        _dontdump = madvise(ptr, _bytes, MADV_DONTDUMP) == 0;
+#   elif defined(MADV_NOCORE)
+        _dontdump = madvise(ptr, _bytes, MADV_NOCORE) == 0;
+#   endif
+        return ptr;
+#elif defined(_WIN32)
+        void* ptr = VirtualAlloc(nullptr, _bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if ( !ptr )
+            throw std::bad_alloc();
+        _locked = VirtualLock(ptr, _bytes) != 0;
+        return ptr;
+#else
+        (void)_locked; (void)_dontdump;
+        return ::operator new(_bytes);
+#endif
+    }
+
+    static void unmap( void* _ptr, size_t _bytes, bool _locked ) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        if ( _locked )
+            munlock(_ptr, _bytes);
+        munmap(_ptr, _bytes);
+#elif defined(_WIN32)
+        if ( _locked )
+            VirtualUnlock(_ptr, _bytes);
+        VirtualFree(_ptr, 0, MEM_RELEASE);
+#else
+        (void)_bytes; (void)_locked;
+        ::operator delete(_ptr);
+#endif
+    }
+
+    unsigned char* region;
+    size_t region_bytes;
+    size_t class_bytes;
+    bool locked;
+    bool dontdump;
+    std::atomic<size_t> fallbacks;
+    size_class classes[class_count];
+};
+
+namespace detail {
+
+// allocator interface over a secure_page_pool, wrapped by zero_plugin_allocator in page_pool_allocator
+template < class T >
+struct page_pool_allocator_base {
+    typedef T value_type;
+    typedef T* pointer;
+
+    explicit page_pool_allocator_base( secure_page_pool& _pool ) noexcept : pool(&_pool) {}
+    template < class U >
+    page_pool_allocator_base( const page_pool_allocator_base<U>& _other ) noexcept : pool(_other.pool) {}
+
+    T* allocate( size_t _count ) {
+        if ( _count > static_cast<size_t>(-1) / sizeof(T) )
+            throw std::bad_alloc();
+        return static_cast<T*>(pool->allocate(_count * sizeof(T)));
+    }
+    void deallocate( T* _ptr, size_t _count ) noexcept {
+        pool->deallocate(_ptr, _count * sizeof(T));
+    }
+
+    template < class U, class... Args >
+    void construct( U* _ptr, Args&&... _args ) {
+        ::new (static_cast<void*>(_ptr)) U(std::forward<Args>(_args)...);
+    }
+    template < class U >
+    void destroy( U* _ptr ) {
+        _ptr->~U();
+    }
+
+    template < class U >
+    bool operator == ( const page_pool_allocator_base<U>& _other ) const noexcept { return pool == _other.pool; }
+    template < class U >
+    bool operator != ( const page_pool_allocator_base<U>& _other ) const noexcept { return pool != _other.pool; }
+
+    secure_page_pool* pool;
+};
+
+}
+
+// std-compatible allocator over a secure_page_pool, every deallocation and destruction is wiped
+//
+//     cs::secure_page_pool pool;
+//     std::vector<char, cs::page_pool_allocator<char>> buffer{cs::page_pool_allocator<char>{pool}};
+template < class T >
+using page_pool_allocator = zero_plugin_allocator< detail::page_pool_allocator_base<T> >;
+
+}
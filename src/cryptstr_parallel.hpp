@@ -0,0 +1,117 @@
+#pragma once
+
+// global includes
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// local includes
+#include "cryptstr.hpp"
+#include "cryptstr_blob.hpp"
+
+/**
+    CS_PARALLEL_CHUNK
+
+    Bytes decrypted per work item by decrypt_parallel, rounded down to a multiple of 64. Workers take
+    chunks from a shared atomic cursor, so faster threads take more of them. Each chunk starts at a
+    64 byte boundary of the destination, so threads never write to the same cache line if the
+    destination is 64 byte aligned, and keystream functors decrypt whole keystream blocks.
+*/
+#ifndef CS_PARALLEL_CHUNK
+#   define CS_PARALLEL_CHUNK 65536
+#endif
+
+namespace cs {
+namespace detail {
+
+// decrypts elements [0, _len) of _src into _dst on up to _threads threads, including the calling one.
+// Inputs of less than two chunks are decrypted on the calling thread. If the functor throws, the
+// remaining chunks are skipped and the first exception is rethrown on the calling thread after all
+// helpers joined, _dst is partially written then.
+template < class Functor, class CharType >
+size_t decrypt_parallel( const Functor& _functor, const CharType* _src, size_t _len, CharType* _dst, unsigned _threads ) {
+    static_assert(CS_PARALLEL_CHUNK >= 64 && 64 % sizeof(CharType) == 0, "invalid chunk size");
+    constexpr size_t chunk = (CS_PARALLEL_CHUNK / 64 * 64) / sizeof(CharType);
+    const size_t chunks = (_len + chunk - 1) / chunk;
+    if ( _threads == 0 )
+        _threads = std::max(std::thread::hardware_concurrency(), 1u);
+    if ( chunks < 2 || _threads < 2 )
+        return decrypt_range(_functor, _src, _len, 0, _len, _dst);
+
+    // chunks go through the raw kernel, the whole call counts as one decrypt with CS_ENABLE_STATS
+    const CharType* src = opaque(_src);
+    std::atomic<size_t> cursor{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    auto work = [&]() noexcept {
+        try {
+            Functor f = _functor;
+            for ( size_t index = cursor.fetch_add(1, std::memory_order_relaxed); chunks > index;
+                  index = cursor.fetch_add(1, std::memory_order_relaxed) ) {
+                const size_t offset = index * chunk;
+                const size_t count = ( _len - offset < chunk ) ? _len - offset : chunk;
+                apply_functor(f, src, _len, _dst + offset, offset, count);
+            }
+        } catch ( ... ) {
+            // the first failure is kept, join() publishes it to the calling thread
+            if ( !failed.exchange(true, std::memory_order_relaxed) )
+                error = std::current_exception();
+            cursor.store(chunks, std::memory_order_relaxed);
+        }
+    };
+
+    const size_t helpers = std::min(static_cast<size_t>(_threads), chunks) - 1;
+    std::vector<std::thread> pool;
+    pool.reserve(helpers);
+    for ( size_t i = 0; helpers > i; ++i ) {
+        try {
+            pool.emplace_back(work);
+        } catch ( const std::system_error& ) {
+            // out of threads, the running ones take the remaining chunks
+            break;
+        } catch ( ... ) {
+            // e.g. std::bad_alloc, started helpers are stopped and joined, a joinable thread would terminate
+            cursor.store(chunks, std::memory_order_relaxed);
+            for ( std::thread& thread : pool ) {
+                thread.join();
+            }
+            throw;
+        }
+    }
+    work();
+    for ( std::thread& thread : pool ) {
+        thread.join();
+    }
+    if ( error )
+        std::rethrow_exception(error);
+    CS_STATS(stats_decrypt(_len * sizeof(CharType)));
+    return _len;
+}
+
+}
+
+// decrypts all bytes of _blob into _dst on up to _threads threads, 0 uses std::thread::hardware_concurrency().
+// The caller is responsible for wiping _dst, a 64 byte aligned _dst avoids false sharing between threads.
+// \param _cap capacity of _dst, has to be at least size()
+// \return number of written bytes
+template < class Functor >
+size_t decrypt_parallel( const cryptblob<Functor>& _blob, unsigned char* _dst, size_t _cap, unsigned _threads = 0 ) {
+    if ( _cap < _blob.size() )
+        throw std::length_error("destination too small");
+    return detail::decrypt_parallel(_blob.functor, _blob.data(), _blob.size(), _dst, _threads);
+}
+
+// decrypts all N elements of _crypted into _dst on up to _threads threads, see above
+template < class CharType, size_t N, class Functor >
+size_t decrypt_parallel( const cryptstr<CharType,N,Functor>& _crypted, CharType* _dst, size_t _cap, unsigned _threads = 0 ) {
+    if ( _cap < N )
+        throw std::length_error("destination too small");
+    return detail::decrypt_parallel(_crypted.functor, _crypted.data.get(), N, _dst, _threads);
+}
+
+}
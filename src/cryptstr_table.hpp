@@ -0,0 +1,128 @@
+#pragma once
+
+// global includes
+#include <cstdint>
+#include <stdexcept>
+
+// local includes
+#include "cryptstr.hpp"
+
+namespace cs {
+
+// A small handle into a crypt_table
+struct table_handle {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// An encrypted string table. All strings are packed back to back, without terminators, into one
+// contiguous array that is encrypted as a whole, so element i of the table is transformed with
+// functor(table, Total, i). Strings are addressed by (offset, length) handles.
+// Decrypting neighbouring strings shares cache lines, and the table can be prefetched or decrypted
+// in a single sweep. The runtime code only depends on CharType and Functor, not on the strings.
+//
+//     constexpr auto table = cs::make_table(functor, "first", "second");
+//     auto view = table.decrypt(table[1]);
+template < class CharType, size_t Total, size_t Count, class Functor >
+struct crypt_table {
+    typedef CharType char_type;
+    typedef Functor functor_type;
+
+    static constexpr size_t total_size = Total;
+    static constexpr size_t string_count = Count;
+    static_assert(Count > 0, "a table needs at least one string");
+
+    // packs and encrypts the given literals, dropping their terminators
+    template < size_t... Ns >
+    constexpr crypt_table( functor_type _functor, const char_type (&... _strs)[Ns] ) noexcept
+        : functor(_functor), index{}, data{} {
+        static_assert(sizeof...(Ns) == Count, "invalid string count");
+        static_assert(((Ns - 1) + ... + 0) == Total, "invalid table size");
+        char_type plain[storage_size] = {};
+        size_t offset = 0;
+        size_t count = 0;
+        ( append(plain, offset, count, _strs, Ns - 1), ... );
+        if constexpr ( Total > 0 ) {
+            // block-wise like cs::crypt, apply_all generates each keystream block once instead of per element
+            detail::transform_values(static_cast<const char_type*>(plain), data, _functor);
+        }
+    }
+
+    // number of strings
+    constexpr size_t size() const noexcept { return Count; }
+
+    // returns the handle of the string at _index in construction order
+    constexpr table_handle operator [] ( size_t _index ) const {
+        return ( _index < Count ) ? index[_index] : throw std::out_of_range("index out of range");
+    }
+
+    // decrypts the _handle.length elements of the string into caller memory, without a terminator.
+    // The caller is responsible for wiping _dst.
+    // \return number of written elements
+    size_t decrypt_into( table_handle _handle, char_type* _dst, size_t _cap ) const {
+        check(_handle);
+        if ( _cap < _handle.length )
+            throw std::length_error("destination too small");
+        return detail::decrypt_range(functor, &data[0], Total, _handle.offset, _handle.length, _dst);
+    }
+
+    // returns the string of _handle as strview of _handle.length + 1 elements, ending in a null element
+    // like the strview of cryptstr::decrypt, so data() can be passed to C APIs. The table does not store
+    // terminators, the null element is added here.
+    strview<char_type> decrypt( table_handle _handle ) const {
+        check(_handle);
+        strview<char_type> view = detail::view_access::make<char_type>(_handle.length + size_t(1));
+        if ( _handle.length > 0 )
+            decrypt_into(_handle, &view[0], _handle.length);
+        return view;
+    }
+
+    // decrypts the whole table in one sweep, string h is found at _dst + h.offset.
+    // the caller can wipe all strings with a single memzero of Total elements.
+    size_t decrypt_all( char_type* _dst, size_t _cap ) const {
+        if ( _cap < Total )
+            throw std::length_error("destination too small");
+        return detail::decrypt_range(functor, &data[0], Total, 0, Total, _dst);
+    }
+
+    // pulls the encrypted table into the cache
+    void prefetch() const noexcept {
+#if defined(CS_CLANG) || defined(CS_GCC)
+        const char* bytes = reinterpret_cast<const char*>(&data[0]);
+        for ( size_t i = 0; sizeof(data) > i; i += 64 ) {
+            __builtin_prefetch(bytes + i);
+        }
+#endif
+    }
+
+private:
+    static constexpr size_t storage_size = Total > 0 ? Total : 1;
+
+    template < size_t N >
+    constexpr void append( char_type (&_plain)[storage_size], size_t& _offset, size_t& _count, const char_type (&_str)[N], size_t _len ) noexcept {
+        index[_count] = table_handle{ static_cast<uint32_t>(_offset), static_cast<uint32_t>(_len) };
+        for ( size_t i = 0; _len > i; ++i ) {
+            _plain[_offset + i] = _str[i];
+        }
+        _offset += _len;
+        ++_count;
+    }
+
+    void check( table_handle _handle ) const {
+        if ( _handle.offset > Total || _handle.length > Total - _handle.offset )
+            throw std::out_of_range("handle out of range");
+    }
+
+public:
+    Functor functor;
+    table_handle index[Count];
+    char_type data[storage_size];
+};
+
+// constructs a crypt_table from uncrypted literals
+template < class Functor, class CharType, size_t... Ns >
+constexpr crypt_table<CharType, ((Ns - 1) + ... + 0), sizeof...(Ns), Functor> make_table( Functor _functor, const CharType (&... _strs)[Ns] ) {
+    return crypt_table<CharType, ((Ns - 1) + ... + 0), sizeof...(Ns), Functor>(_functor, _strs...);
+}
+
+}
@@ -0,0 +1,127 @@
+#include <cryptstr_arena.hpp>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "expect.hpp"
+
+/* secure_arena
+    allocations fail cleanly when the arena is exhausted, arena_scope and reset() wipe exactly the
+    released extent, std containers work on arena_allocator and decrypt_batch packs all strings into
+    one allocation or none.
+*/
+// must-not-leak: ArenaUser
+// must-not-leak: ArenaPassword
+
+using test::expect;
+
+template < class Fn >
+bool throws_bad_alloc( Fn&& _fn ) {
+    try {
+        _fn();
+    } catch ( const std::bad_alloc& ) {
+        return true;
+    }
+    return false;
+}
+
+static bool all_zero( const unsigned char* _ptr, size_t _len ) {
+    for ( size_t i = 0; _len > i; ++i ) {
+        if ( _ptr[i] != 0 )
+            return false;
+    }
+    return true;
+}
+
+int main() {
+    alignas(64) static unsigned char storage[1024];
+
+    // exhaustion leaves the arena unchanged
+    {
+        cs::secure_arena arena(storage, sizeof(storage));
+        expect(arena.allocate(1000, 1) != nullptr, "allocation within capacity");
+        expect(throws_bad_alloc([&] { arena.allocate(100, 1); }), "allocation beyond capacity");
+        expect(arena.used() == 1000, "a failed allocation does not move the top");
+        expect(throws_bad_alloc([&] { arena.allocate_array<uint64_t>(static_cast<size_t>(-1) / 4); }), "overflowing array");
+        expect(arena.allocate(24, 1) != nullptr && arena.remaining() == 0, "the remaining bytes are usable");
+        arena.reset();
+        arena.allocate(1, 1);
+        const void* aligned = arena.allocate(8, 64);
+        expect(reinterpret_cast<uintptr_t>(aligned) % 64 == 0, "aligned allocation");
+        expect(arena.high_water() == 1024, "high water mark survives reset");
+    }
+    expect(all_zero(storage, sizeof(storage)), "destructor wipes the used extent");
+
+    // arena_scope rewinds to its mark and wipes only what was allocated in the scope
+    {
+        cs::secure_arena arena(storage, sizeof(storage));
+        unsigned char* outer = static_cast<unsigned char*>(arena.allocate(64, 1));
+        std::memset(outer, 0xaa, 64);
+        {
+            cs::arena_scope scope(arena);
+            unsigned char* inner = static_cast<unsigned char*>(arena.allocate(128, 1));
+            std::memset(inner, 0xbb, 128);
+            expect(arena.used() == 192, "used inside the scope");
+        }
+        expect(arena.used() == 64, "scope rewinds to its mark");
+        expect(all_zero(storage + 64, 128), "scope wipes its allocations");
+        expect(outer[0] == 0xaa && outer[63] == 0xaa, "scope keeps earlier allocations");
+        arena.reset();
+        expect(arena.used() == 0 && all_zero(storage, 64), "reset wipes everything");
+    }
+
+    // std containers on arena_allocator
+    {
+        cs::secure_arena arena(16384);
+        std::vector<int, cs::arena_allocator<int>> numbers{cs::arena_allocator<int>(arena)};
+        for ( int i = 0; 100 > i; ++i ) {
+            numbers.push_back(i);
+        }
+        expect(numbers.size() == 100 && numbers[99] == 99, "vector on an arena");
+        typedef std::basic_string<char, std::char_traits<char>, cs::arena_allocator<char>> arena_string;
+        arena_string text{cs::arena_allocator<char>(arena)};
+        text.assign(200, 'x');
+        expect(text.size() == 200, "string on an arena");
+        std::map<int, int, std::less<int>, cs::arena_allocator<std::pair<const int, int>>> map{
+            cs::arena_allocator<std::pair<const int, int>>(arena)};
+        map[1] = 2;
+        map[3] = 4;
+        expect(map.size() == 2 && map[3] == 4, "map with rebound allocator");
+        expect(arena.used() > 600, "containers allocate from the arena");
+#if defined(CS_HAS_PMR)
+        cs::arena_resource resource(arena);
+        std::pmr::vector<int> pmr_numbers(&resource);
+        pmr_numbers.assign(50, 7);
+        expect(pmr_numbers.size() == 50, "pmr vector on an arena");
+#endif
+    }
+
+    // decrypt and decrypt_batch
+    {
+        static constexpr auto user = cs::crypt(cs::xorshift_keystream(31), "ArenaUser");
+        static constexpr auto pass = cs::crypt(cs::chacha_keystream(32), "ArenaPassword");
+        char buffer[32];
+        const std::string expected_user = test::join(buffer, "Arena", "User");
+        const std::string expected_pass = test::join(buffer, "Arena", "Password");
+
+        cs::secure_arena arena(storage, sizeof(storage));
+        const std::string_view single = cs::decrypt(user, arena);
+        expect(std::strcmp(single.data(), expected_user.c_str()) == 0, "decrypt into an arena");
+        const size_t before = arena.used();
+        {
+            cs::arena_scope scope(arena);
+            const auto views = cs::decrypt_batch(arena, user, pass);
+            expect(std::strcmp(views[0].data(), expected_user.c_str()) == 0, "first batch string");
+            expect(std::strcmp(views[1].data(), expected_pass.c_str()) == 0, "second batch string");
+            expect(views[0].size() == user.size() && views[1].size() == pass.size(), "batch views as decrypt() returns them");
+            expect(views[1].data() == views[0].data() + user.size() + 1, "one contiguous allocation");
+            expect(arena.used() - before == user.size() + 1 + pass.size() + 1, "batch size");
+        }
+        expect(arena.used() == before && all_zero(storage + before, sizeof(storage) - before), "batch wiped by the scope");
+
+        cs::secure_arena small(storage, user.size() + 4);
+        expect(throws_bad_alloc([&] { cs::decrypt_batch(small, user, pass); }), "batch larger than the arena");
+        expect(small.used() == 0, "a failed batch allocates nothing");
+    }
+    return test::result();
+}
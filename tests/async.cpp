@@ -0,0 +1,66 @@
+#include <cryptstr_async.hpp>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include "expect.hpp"
+
+using test::expect;
+
+/* decrypt_async
+    work runs on a bounded pool, results and exceptions arrive through the future,
+    and a pool finishes its queued tasks before it is destroyed.
+*/
+// must-not-leak: AsyncSecret
+
+// per element functor that always fails
+struct failing_functor {
+    unsigned char operator () ( const unsigned char*, size_t, size_t ) const {
+        throw std::runtime_error("functor failed");
+    }
+};
+
+int main() {
+    static constexpr auto crypted = cs::crypt(cs::xorshift_keystream(11), "AsyncSecret");
+    char buffer[16];
+    const char* expected = test::join(buffer, "Async", "Secret");
+
+    // many requests share the bounded default pool
+    std::vector<std::future<cs::strview<char>>> futures;
+    for ( size_t i = 0; 200 > i; ++i ) {
+        futures.push_back(cs::decrypt_async(crypted));
+    }
+    for ( auto& future : futures ) {
+        const auto plain = future.get();
+        expect(std::strcmp(plain.c_str(), expected) == 0, "decrypt_async result");
+    }
+
+    // a pool never runs tasks on more threads than it has workers
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    {
+        cs::thread_pool pool(3);
+        expect(pool.size() == 3, "pool size");
+        for ( size_t i = 0; 500 > i; ++i ) {
+            pool.post([&] {
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(std::this_thread::get_id());
+            });
+        }
+        // the destructor runs all queued tasks before joining
+    }
+    expect(ids.size() <= 3, "at most three worker threads");
+    expect(ids.count(std::this_thread::get_id()) == 0, "tasks do not run on the posting thread");
+
+    // exceptions of the functor arrive through the future
+    unsigned char bytes[4] = {};
+    const cs::cryptblob<failing_functor> blob(failing_functor(), bytes, sizeof(bytes));
+    auto future = cs::decrypt_async(blob);
+    try {
+        future.get();
+        expect(false, "exception through the future");
+    } catch ( const std::runtime_error& ) {
+    }
+    return test::result();
+}
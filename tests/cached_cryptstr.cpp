@@ -0,0 +1,41 @@
+#include <cryptstr_cached.hpp>
+#include <string_view>
+#include "expect.hpp"
+
+using test::expect;
+
+/* cached_cryptstr
+    instances built from a constexpr cryptstr or declared constinit are constant-initialized,
+    get() returns the plaintext without the terminating null element.
+*/
+// must-not-leak: X-Api-Token
+// must-not-leak: X-Constinit
+
+static constexpr auto token = cs::crypt(cs::xor_functor<0x2a>(), "X-Api-Token");
+static cs::cached_cryptstr header(token);
+#if defined(__cpp_constinit)
+constinit static cs::cached_cryptstr other(cs::crypt(cs::xorshift_keystream(9), "X-Constinit"));
+#endif
+
+int main() {
+    char buffer[32];
+    const char* expected = test::join(buffer, "X-Api", "-Token");
+
+    expect(!header.cached(), "not decrypted before get()");
+    const std::string_view name = header.get();
+    expect(header.cached(), "decrypted after get()");
+    expect(name == std::string_view(expected), "get() equals the literal");
+    expect(name.size() == token.size() - 1, "get() drops the terminator");
+    expect(name.data()[name.size()] == '\0', "data() stays null terminated");
+    expect(header.get().data() == name.data(), "later get() returns the cached buffer");
+
+    header.evict();
+    expect(!header.cached(), "evicted");
+    expect(header.get() == std::string_view(expected), "decrypted again after evict()");
+
+#if defined(__cpp_constinit)
+    expected = test::join(buffer, "X", "-Constinit");
+    expect(other.get() == std::string_view(expected), "constinit instance");
+#endif
+    return test::result();
+}
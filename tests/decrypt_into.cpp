@@ -0,0 +1,85 @@
+#include <cryptstr.hpp>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include "expect.hpp"
+
+/* decrypt_into and decrypt_static
+    decrypt_into writes all N elements into caller memory and throws std::length_error for a smaller
+    capacity, static_strview holds the plaintext inline and wipes it on destruction.
+*/
+// must-not-leak: IntoSecret
+// variant: -DCS_SHARED_KERNEL
+
+using test::expect;
+
+int main() {
+    static constexpr auto crypted = cs::crypt(cs::xorshift_keystream(41), "IntoSecret");
+    constexpr size_t N = crypted.size();
+    char buffer[32];
+    const char* expected = test::join(buffer, "Into", "Secret");
+
+    // pointer and capacity
+    char out[32];
+    std::memset(out, '#', sizeof(out));
+    expect(crypted.decrypt_into(out, N) == N, "exact capacity");
+    expect(std::strcmp(out, expected) == 0, "decrypted with terminator");
+    bool threw = false;
+    try {
+        crypted.decrypt_into(out, N - 1);
+    } catch ( const std::length_error& ) {
+        threw = true;
+    }
+    expect(threw, "capacity below size() throws std::length_error");
+
+    // array overload, larger arrays keep their tail
+    char array[N + 4];
+    std::memset(array, '#', sizeof(array));
+    expect(crypted.decrypt_into(array) == N, "array overload");
+    expect(std::strcmp(array, expected) == 0 && array[N] == '#', "array overload writes N elements");
+    char exact[N];
+    expect(crypted.decrypt_into(exact) == N && std::strcmp(exact, expected) == 0, "array of exactly N elements");
+#if defined(__cpp_lib_span)
+    expect(crypted.decrypt_into(std::span<char>(out)) == N, "span overload");
+#endif
+
+    // wide strings
+    constexpr auto wide = cs::crypt(cs::chacha_keystream(42), L"wide into");
+    wchar_t wide_out[wide.size()];
+    expect(wide.decrypt_into(wide_out) == wide.size() && std::wcscmp(wide_out, L"wide into") == 0, "wide array overload");
+
+    // static_strview
+    {
+        const auto plain = crypted.decrypt_static();
+        expect(plain.size() == N && std::strcmp(plain.c_str(), expected) == 0, "decrypt_static content");
+        expect(plain.c_str()[plain.size()] == '\0', "c_str() stays terminated");
+        expect(plain.front() == 'I' && plain[4] == 'S', "element access");
+        threw = false;
+        try {
+            plain.at(N);
+        } catch ( const std::out_of_range& ) {
+            threw = true;
+        }
+        expect(threw, "at() throws beyond size()");
+        std::ostringstream stream;
+        stream << plain;
+        expect(std::strcmp(stream.str().c_str(), expected) == 0, "stream output");
+    }
+
+    // the inline storage is wiped on destruction
+    typedef cs::static_strview<char,N> inline_view;
+    alignas(inline_view) unsigned char storage[sizeof(inline_view)];
+    std::memset(storage, 0xee, sizeof(storage));
+    inline_view* view = ::new (static_cast<void*>(storage)) inline_view(crypted);
+    expect(std::strcmp(view->c_str(), expected) == 0, "constructed in place");
+    view->~inline_view();
+    // read through volatile, the storage holds no object anymore
+    const volatile unsigned char* bytes = storage;
+    bool wiped = true;
+    for ( size_t i = 0; sizeof(storage) > i; ++i ) {
+        wiped = wiped && bytes[i] == 0;
+    }
+    expect(wiped, "static_strview wipes its storage");
+    return test::result();
+}
@@ -0,0 +1,90 @@
+#define CS_STREAM_CHUNK 16
+#include <cryptstr.hpp>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "expect.hpp"
+
+/* decrypt_to
+    every sink kind receives the N-1 plaintext elements without the terminating null element,
+    in CS_STREAM_CHUNK sized chunks, and a failing sink stops the stream.
+*/
+// must-not-leak: StreamedSecret
+
+using test::expect;
+
+int main() {
+    static constexpr auto crypted = cs::crypt(cs::xorshift_keystream(21), "StreamedSecretStreamedSecret-40-elements");
+    static_assert(crypted.size() == 41, "40 elements and the terminator");
+    char buffer[64];
+    std::string expected = test::join(buffer, "Streamed", "Secret");
+    expected = expected + expected + test::join(buffer, "-40-", "elements");
+
+    // std::ostream
+    std::ostringstream stream;
+    expect(crypted.decrypt_to(stream) == 40, "ostream count");
+    expect(stream.str() == expected, "ostream content without terminator");
+
+    // std::wostream
+    constexpr auto wide = cs::crypt(cs::chacha_keystream(22), L"wide stream");
+    std::wostringstream wstream;
+    expect(wide.decrypt_to(wstream) == 11, "wostream count");
+    expect(wstream.str() == L"wide stream", "wostream content");
+
+    // callable without result
+    std::string collected;
+    size_t calls = 0;
+    crypted.decrypt_to([&]( const char* _str, size_t _len ) {
+        collected.append(_str, _len);
+        ++calls;
+    });
+    expect(collected == expected, "callable content");
+    expect(calls == 3, "16 byte chunks");
+
+    // callable failing on the second chunk
+    calls = 0;
+    const size_t written = crypted.decrypt_to([&]( const char*, size_t ) {
+        return ++calls < 2;
+    });
+    expect(written == 16, "failing callable stops after the written chunk");
+    expect(calls == 2, "no call after the failure");
+
+    // a failed ostream
+    std::ostringstream bad;
+    bad.setstate(std::ios::badbit);
+    expect(crypted.decrypt_to(bad) == 0, "failed ostream");
+
+    // std::FILE*
+    std::FILE* file = std::tmpfile();
+    expect(file != nullptr, "tmpfile");
+    if ( file ) {
+        expect(crypted.decrypt_to(file) == 40, "FILE* count");
+        std::rewind(file);
+        char read_back[64] = {};
+        const size_t num = std::fread(read_back, 1, sizeof(read_back), file);
+        expect(num == 40 && expected.compare(0, 40, read_back, num) == 0, "FILE* content without terminator");
+        std::fclose(file);
+    }
+
+    // cs::fd_sink
+    int fds[2];
+    expect(::pipe(fds) == 0, "pipe");
+    expect(crypted.decrypt_to(cs::fd_sink{fds[1]}) == 40, "fd_sink count");
+    ::close(fds[1]);
+    std::string piped;
+    char chunk[16];
+    for ( ssize_t num; (num = ::read(fds[0], chunk, sizeof(chunk))) > 0; ) {
+        piped.append(chunk, static_cast<size_t>(num));
+    }
+    ::close(fds[0]);
+    expect(piped == expected, "fd_sink content without terminator");
+    expect(!crypted.decrypt_to(cs::fd_sink{-1}), "invalid descriptor");
+
+    // the empty string writes nothing
+    constexpr auto empty = cs::crypt(cs::xor_functor<0x2a>(), "");
+    std::ostringstream nothing;
+    expect(empty.decrypt_to(nothing) == 0 && nothing.str().empty(), "empty string");
+    return test::result();
+}
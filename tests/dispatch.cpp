@@ -0,0 +1,34 @@
+#include <cryptstr_dispatch.hpp>
+#include <cstring>
+#include "expect.hpp"
+
+using test::expect;
+
+/* dispatch
+    find() accepts keys with or without their terminating null element,
+    the table is a constant expression and no key reaches the binary in plaintext.
+*/
+// must-not-leak: CommandGet
+// must-not-leak: CommandPut
+// must-not-leak: CommandDelete
+
+constexpr cs::xor_functor<0x2a> functor;
+constexpr auto commands = cs::make_dispatch(cs::crypt(functor, "CommandGet"), cs::crypt(functor, "CommandPut"),
+    cs::crypt(cs::xorshift_keystream(3), "CommandDelete"));
+static_assert(commands.size() == 3, "three keys");
+
+int main() {
+    char input[32];
+    const char* names[] = { "Get", "Put", "Delete" };
+    for ( size_t i = 0; 3 > i; ++i ) {
+        const size_t len = std::strlen(test::join(input, "Command", names[i]));
+        expect(commands.find(input, len) == i, "key without terminator");
+        expect(commands.find(input, len + 1) == i, "key with terminator");
+        expect(commands.find(std::string_view(input)) == i, "string_view key");
+        expect(commands.find(input, len - 1) == commands.npos, "prefix of a key");
+    }
+    expect(commands.find("CommandPost", 11) == commands.npos, "unknown key");
+    expect(commands.find("", 0) == commands.npos, "empty input");
+    expect(commands.find("", 1) == commands.npos, "only a terminator");
+    return test::result();
+}
@@ -0,0 +1,75 @@
+#include <cryptstr.hpp>
+#include <cstring>
+#include <string_view>
+#include "expect.hpp"
+
+/* equals
+    runtime input is compared with the plaintext without decrypting it, for per element and keystream
+    functors, with or without the terminating null element, and inputs of other lengths never match.
+*/
+// must-not-leak: EqualsPerElement
+// must-not-leak: EqualsKeystream
+
+using test::expect;
+
+template < class Crypted >
+void check( const Crypted& _crypted, const char* _plain, const char* _what ) {
+    std::printf("%s\n", _what);
+    char input[256];
+    const size_t len = std::strlen(_plain);
+    std::memcpy(input, _plain, len + 1);
+
+    expect(_crypted.equals(input, len), "equal without terminator");
+    expect(_crypted.equals(input, len + 1), "equal with terminator");
+    expect(_crypted.equals(std::string_view(input)), "equal string_view");
+
+    expect(!_crypted.equals(input, len - 1), "shorter input");
+    input[len + 1] = 'x';
+    expect(!_crypted.equals(input, len + 2), "longer input");
+    input[len] = 'x';
+    expect(!_crypted.equals(input, len + 1), "non-null element in place of the terminator");
+    input[len] = '\0';
+
+    input[0] ^= 1;
+    expect(!_crypted.equals(input, len), "first element differs");
+    input[0] ^= 1;
+    input[len - 1] ^= 1;
+    expect(!_crypted.equals(input, len), "last element differs");
+    expect(!_crypted.equals(input, len + 1), "last element differs, with terminator");
+    input[len - 1] ^= 1;
+    expect(_crypted.equals(input, len), "equal again after restoring the input");
+}
+
+#define CS_TEST_LONG "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-_0123456789"
+
+int main() {
+    // constexpr objects, a cs::crypt call passed straight as an argument may be evaluated at runtime at -O0
+    static constexpr auto per_element = cs::crypt(cs::xor_functor<0x2a>(), "EqualsPerElement");
+    static constexpr auto xorshift = cs::crypt(cs::xorshift_keystream(5), "EqualsKeystream");
+    static constexpr auto pcg = cs::crypt(cs::pcg_keystream(6), "EqualsKeystream");
+    static constexpr auto chacha = cs::crypt(cs::chacha_keystream(7), "EqualsKeystream");
+    static constexpr auto chacha_long = cs::crypt(cs::chacha_keystream(8), CS_TEST_LONG);
+    static constexpr auto xor_long = cs::crypt(cs::xor_functor<0x11>(), CS_TEST_LONG);
+
+    char buffer[64];
+    check(per_element, test::join(buffer, "Equals", "PerElement"), "xor_functor");
+    check(xorshift, test::join(buffer, "Equals", "Keystream"), "xorshift_keystream");
+    check(pcg, test::join(buffer, "Equals", "Keystream"), "pcg_keystream");
+    check(chacha, test::join(buffer, "Equals", "Keystream"), "chacha_keystream");
+    // longer than one 64 element block of encrypted_equals
+    check(chacha_long, CS_TEST_LONG, "chacha_keystream, 75 elements");
+    check(xor_long, CS_TEST_LONG, "xor_functor, 75 elements");
+
+    // the empty literal only equals empty input
+    constexpr auto empty = cs::crypt(cs::xorshift_keystream(9), "");
+    expect(empty.equals("", 0), "empty input");
+    expect(empty.equals("", 1), "only a terminator");
+    expect(!empty.equals("a", 1), "one element against the empty literal");
+
+    // wide characters
+    constexpr auto wide = cs::crypt(cs::xorshift_keystream(10), L"Wide");
+    expect(wide.equals(L"Wide", 4), "wide equal");
+    expect(wide.equals(std::wstring_view(L"Wide")), "wide string_view");
+    expect(!wide.equals(L"Wida", 4), "wide unequal");
+    return test::result();
+}
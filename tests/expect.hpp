@@ -0,0 +1,37 @@
+#pragma once
+
+// global includes
+#include <cstddef>
+#include <cstdio>
+
+/* minimal test helpers
+    shared by the tests in tests/, a test returns test::result() from main
+*/
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+// reports _what and fails the test if _condition does not hold
+inline void expect( bool _condition, const char* _what ) {
+    if ( !_condition ) {
+        std::printf("failed: %s\n", _what);
+        ++failures();
+    }
+}
+
+inline int result() {
+    return failures() == 0 ? 0 : 1;
+}
+
+// writes _head and _tail to _buffer. Expected plaintext is assembled at runtime like this,
+// so literals listed as must-not-leak do not end up in the test binary through the test itself.
+template < size_t N >
+const char* join( char (&_buffer)[N], const char* _head, const char* _tail ) {
+    std::snprintf(_buffer, N, "%s%s", _head, _tail);
+    return _buffer;
+}
+
+}
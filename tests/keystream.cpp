@@ -0,0 +1,85 @@
+#include <cryptstr.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "expect.hpp"
+
+/* keystream functors
+    the runtime apply_block kernels produce the same elements as the per element path and apply_all,
+    which encrypt at compile time, at any offset and count and for every element size.
+*/
+// variant: -DCS_NO_SIMD
+
+using test::expect;
+
+template < class Functor, class CharType >
+void check( const char* _name, uint64_t _seed ) {
+    const Functor functor(_seed);
+    const size_t size = 1024;
+    std::vector<CharType> plain(size);
+    for ( size_t i = 0; size > i; ++i ) {
+        plain[i] = static_cast<CharType>(i * 2654435761u);
+    }
+
+    // reference: one element at a time
+    std::vector<CharType> reference(size);
+    for ( size_t i = 0; size > i; ++i ) {
+        reference[i] = functor(plain.data(), size, i);
+    }
+    std::vector<CharType> all(size);
+    functor.apply_all(plain.data(), all.data(), size);
+    if ( all != reference ) {
+        std::printf("%s, %zu byte elements: ", _name, sizeof(CharType));
+        expect(false, "apply_all differs from the per element path");
+    }
+
+    // offsets and counts around block boundaries, destinations shifted against the source
+    const size_t offsets[] = { 0, 1, 3, 7, 15, 16, 31, 32, 33, 63, 64, 65, 127, 128, 200, 511 };
+    const size_t counts[] = { 0, 1, 2, 5, 31, 32, 33, 63, 64, 65, 100, 128, 129, 255, 256, 257, 500 };
+    std::vector<CharType> output(size + 4);
+    for ( size_t shift = 0; 4 > shift; ++shift ) {
+        for ( size_t offset : offsets ) {
+            for ( size_t count : counts ) {
+                if ( offset + count > size )
+                    continue;
+                CharType* dst = output.data() + shift;
+                functor.apply_block(plain.data() + offset, dst, offset, count);
+                for ( size_t i = 0; count > i; ++i ) {
+                    if ( dst[i] != reference[offset + i] ) {
+                        std::printf("%s, %zu byte elements, offset %zu, count %zu, shift %zu: ",
+                            _name, sizeof(CharType), offset, count, shift);
+                        expect(false, "apply_block differs from the per element path");
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // decrypting the encrypted elements restores the plaintext
+    std::vector<CharType> decrypted(size);
+    functor.apply_block(reference.data(), decrypted.data(), 0, size);
+    if ( decrypted != plain ) {
+        std::printf("%s, %zu byte elements: ", _name, sizeof(CharType));
+        expect(false, "apply_block does not invert the encryption");
+    }
+}
+
+template < class Functor >
+void check_all( const char* _name ) {
+    for ( uint64_t seed : { UINT64_C(0), UINT64_C(1), UINT64_C(0x9e3779b97f4a7c15) } ) {
+        check<Functor,char>(_name, seed);
+        check<Functor,wchar_t>(_name, seed);
+        check<Functor,char16_t>(_name, seed);
+        check<Functor,char32_t>(_name, seed);
+    }
+}
+
+int main() {
+    const cs::detail::cpu_features& cpu = cs::detail::cpu();
+    std::printf("avx2=%d avx512f=%d\n", cpu.avx2 ? 1 : 0, cpu.avx512f ? 1 : 0);
+    check_all<cs::xorshift_keystream>("xorshift");
+    check_all<cs::pcg_keystream>("pcg");
+    check_all<cs::chacha_keystream>("chacha");
+    return test::result();
+}
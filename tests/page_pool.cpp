@@ -0,0 +1,132 @@
+#include <cryptstr_pagepool.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "expect.hpp"
+
+/* secure_page_pool
+    requests map to the smallest fitting size class, oversized requests and exhausted classes fall back
+    to the heap and are counted, the free lists hand every slot to one owner at a time under concurrent
+    use, and page_pool_allocator wipes destroyed elements and released slots.
+*/
+
+using test::expect;
+
+static size_t in_use( const cs::secure_page_pool& _pool ) {
+    const cs::page_pool_stats stats = _pool.stats();
+    size_t total = 0;
+    for ( size_t c = 0; stats.class_count > c; ++c ) {
+        total += stats.classes[c].in_use;
+    }
+    return total;
+}
+
+int main() {
+    // size class selection
+    {
+        cs::secure_page_pool pool(16384);
+        const size_t sizes[] = { 1, 16, 17, 32, 33, 100, 1000, 2048, 2049, 4096 };
+        const size_t classes[] = { 0, 0, 1, 1, 2, 3, 6, 7, 8, 8 };
+        for ( size_t i = 0; sizeof(sizes) / sizeof(sizes[0]) > i; ++i ) {
+            void* ptr = pool.allocate(sizes[i]);
+            const cs::page_pool_stats stats = pool.stats();
+            const size_t slot = stats.classes[classes[i]].slot_size;
+            expect(pool.owns(ptr), "served from the region");
+            expect(stats.classes[classes[i]].in_use == 1, "smallest fitting size class");
+            expect(in_use(pool) == 1, "one slot in use");
+            expect(reinterpret_cast<uintptr_t>(ptr) % slot == 0, "aligned to the slot size");
+            pool.deallocate(ptr, sizes[i]);
+            expect(in_use(pool) == 0, "slot returned");
+        }
+        expect(pool.stats().fallbacks == 0, "no fallbacks for slot sized requests");
+    }
+
+    // heap fallback accounting
+    {
+        cs::secure_page_pool pool(16384);
+        void* large = pool.allocate(4097);
+        expect(!pool.owns(large), "oversized request from the heap");
+        expect(pool.stats().fallbacks == 1, "oversized request counted");
+        pool.deallocate(large, 4097);
+
+        const size_t slots = pool.stats().classes[8].slots;
+        std::vector<void*> pages;
+        for ( size_t i = 0; slots > i; ++i ) {
+            pages.push_back(pool.allocate(4096));
+        }
+        expect(pool.stats().fallbacks == 1 && pool.stats().classes[8].in_use == slots, "class filled from the region");
+        void* extra = pool.allocate(4096);
+        expect(!pool.owns(extra), "exhausted class falls back to the heap");
+        expect(pool.stats().fallbacks == 2, "exhausted class counted");
+        expect(pool.stats().classes[8].peak == slots, "peak of the full class");
+        pool.deallocate(extra, 4096);
+        for ( void* page : pages ) {
+            pool.deallocate(page, 4096);
+        }
+        expect(in_use(pool) == 0 && pool.stats().classes[8].peak == slots, "peak survives deallocation");
+    }
+
+    // concurrent allocate and deallocate, every slot is owned by one thread at a time
+    {
+        cs::secure_page_pool pool(16384);
+        std::atomic<size_t> clashes{0};
+        std::vector<std::thread> threads;
+        for ( unsigned t = 0; 4 > t; ++t ) {
+            threads.emplace_back([&pool, &clashes, t] {
+                const unsigned char mark = static_cast<unsigned char>(t + 1);
+                std::vector<std::pair<unsigned char*, size_t>> held;
+                for ( size_t i = 0; 20000 > i; ++i ) {
+                    const size_t size = size_t(16) << ((i * 7 + t) % 4);
+                    unsigned char* ptr = static_cast<unsigned char*>(pool.allocate(size));
+                    std::memset(ptr, mark, size);
+                    held.emplace_back(ptr, size);
+                    if ( held.size() > 32 || i % 3 == 0 ) {
+                        const auto slot = held.front();
+                        held.erase(held.begin());
+                        for ( size_t b = 0; slot.second > b; ++b ) {
+                            if ( slot.first[b] != mark ) {
+                                clashes.fetch_add(1);
+                                break;
+                            }
+                        }
+                        pool.deallocate(slot.first, slot.second);
+                    }
+                }
+                for ( const auto& slot : held ) {
+                    pool.deallocate(slot.first, slot.second);
+                }
+            });
+        }
+        for ( std::thread& thread : threads ) {
+            thread.join();
+        }
+        expect(clashes.load() == 0, "no slot handed out twice");
+        expect(in_use(pool) == 0, "all slots returned");
+        expect(pool.stats().fallbacks == 0, "concurrent use within the class sizes");
+    }
+
+    // page_pool_allocator wipes destroyed elements and released slots
+    {
+        cs::secure_page_pool pool(16384);
+        const unsigned char* storage = nullptr;
+        size_t bytes = 0;
+        {
+            std::vector<uint64_t, cs::page_pool_allocator<uint64_t>> values{cs::page_pool_allocator<uint64_t>{pool}};
+            values.assign(32, UINT64_C(0x5353535353535353));
+            storage = reinterpret_cast<const unsigned char*>(values.data());
+            bytes = values.capacity() * sizeof(uint64_t);
+            expect(pool.owns(storage), "vector storage in the region");
+            values.pop_back();
+            expect(values.data()[values.size()] == 0, "destroyed element wiped");
+        }
+        bool wiped = true;
+        for ( size_t i = 0; bytes > i; ++i ) {
+            wiped = wiped && storage[i] == 0;
+        }
+        expect(wiped, "released slot wiped");
+        expect(in_use(pool) == 0, "slot returned by the allocator");
+    }
+    return test::result();
+}
@@ -0,0 +1,67 @@
+#include <cryptstr_parallel.hpp>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+/* decrypt_parallel
+    decrypts large inputs on several threads, and an exception of the functor on any thread
+    reaches the caller instead of terminating the process. With CS_ENABLE_STATS a call counts
+    as one decrypt, however many chunks it is split into.
+*/
+// variant: -DCS_ENABLE_STATS
+
+// per element functor that fails at one index
+struct failing_functor {
+    size_t fail_at;
+
+    unsigned char operator () ( const unsigned char* _str, size_t _len, size_t _index ) const {
+        (void)_len;
+        if ( _index == fail_at )
+            throw std::runtime_error("functor failed");
+        return static_cast<unsigned char>(_str[_index] ^ 0x5a);
+    }
+};
+
+int main() {
+    int failed = 0;
+    const size_t size = 4 * CS_PARALLEL_CHUNK + 123;
+    std::vector<unsigned char> plain(size), crypted(size), output(size);
+    for ( size_t i = 0; size > i; ++i ) {
+        plain[i] = static_cast<unsigned char>(i * 131);
+    }
+
+    const cs::xorshift_keystream keystream(3);
+    keystream.apply_block(plain.data(), crypted.data(), 0, size);
+    const cs::cryptblob<cs::xorshift_keystream> blob(keystream, crypted.data(), size);
+    for ( unsigned threads = 1; 8 >= threads; threads *= 2 ) {
+        cs::decrypt_parallel(blob, output.data(), output.size(), threads);
+        if ( output != plain ) {
+            std::printf("mismatch on %u threads\n", threads);
+            failed = 1;
+        }
+    }
+
+#if defined(CS_ENABLE_STATS)
+    const cs::stats_snapshot before = cs::stats();
+    cs::decrypt_parallel(blob, output.data(), output.size(), 4);
+    const cs::stats_snapshot after = cs::stats();
+    if ( after.decrypt_calls - before.decrypt_calls != 1 || after.decrypt_bytes - before.decrypt_bytes != size ) {
+        std::printf("stats: %llu calls, %llu bytes for one call\n",
+            static_cast<unsigned long long>(after.decrypt_calls - before.decrypt_calls),
+            static_cast<unsigned long long>(after.decrypt_bytes - before.decrypt_bytes));
+        failed = 1;
+    }
+#endif
+
+    // fail in the last chunk, which a helper thread takes on more than one thread
+    for ( size_t fail_at : { size_t(0), size - 1 } ) {
+        const cs::cryptblob<failing_functor> failing(failing_functor{fail_at}, crypted.data(), size);
+        try {
+            cs::decrypt_parallel(failing, output.data(), output.size(), 4);
+            std::printf("no exception for index %zu\n", fail_at);
+            failed = 1;
+        } catch ( const std::runtime_error& ) {
+        }
+    }
+    return failed;
+}
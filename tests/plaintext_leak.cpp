@@ -0,0 +1,38 @@
+#include <cryptstr.hpp>
+#include <cstdio>
+#include <cstring>
+#include "expect.hpp"
+
+/* cs::crypt calls that are not manifestly constant-evaluated
+    must still be encrypted at compile time, no plaintext literal may reach the binary.
+*/
+// must-not-leak: LocalAutoQQ
+// must-not-leak: LocalKeystreamQQ
+// must-not-leak: LocalMacroQQ
+// must-not-leak: StaticHoldQ
+
+struct holder {
+    cs::cryptstr<char,12,cs::xor_functor<0x2a>> crypted;
+};
+static holder global{cs::crypt(cs::xor_functor<0x2a>(), "StaticHoldQ")};
+
+int main() {
+    auto local = cs::crypt(cs::xor_functor<0x2a>(), "LocalAutoQQ");
+    auto keystream = cs::crypt(cs::xorshift_keystream(5), "LocalKeystreamQQ");
+    auto macro = CS_CRYPT("LocalMacroQQ");
+
+    int failed = 0;
+    auto check = [&]( const auto& _crypted, const char* _expected ) {
+        const auto plain = _crypted.decrypt();
+        if ( std::strcmp(plain.c_str(), _expected) != 0 ) {
+            std::printf("decrypt mismatch, expected %zu chars\n", std::strlen(_expected));
+            failed = 1;
+        }
+    };
+    char buffer[32];
+    check(local, test::join(buffer, "Local", "AutoQQ"));
+    check(keystream, test::join(buffer, "Local", "KeystreamQQ"));
+    check(macro, test::join(buffer, "Local", "MacroQQ"));
+    check(global.crypted, test::join(buffer, "Static", "HoldQ"));
+    return failed;
+}
@@ -0,0 +1,58 @@
+#define CS_PROFILE
+#include <cryptstr.hpp>
+#include <cstring>
+#include <sstream>
+#include "expect.hpp"
+
+/* CS_PROFILE
+    every site reports the file and line of the caller's cs::crypt or CS_CRYPT, not a location inside
+    the library, and counts the decrypts of its strings.
+*/
+
+using test::expect;
+
+static const cs::profile_entry* find_site( const std::vector<cs::profile_entry>& _sites, uint32_t _line ) {
+    for ( const cs::profile_entry& entry : _sites ) {
+        if ( entry.line == _line && std::strcmp(entry.file, __FILE__) == 0 )
+            return &entry;
+    }
+    return nullptr;
+}
+
+static constexpr auto global = cs::crypt(cs::xor_functor<0x2a>(), "profiled global"); static constexpr uint32_t global_line = __LINE__;
+
+int main() {
+    expect(cs::profile_sites().empty(), "no site before the first decrypt");
+
+    const auto local = cs::crypt(cs::chacha_keystream(3), "profiled local"); const uint32_t local_line = __LINE__;
+    const auto macro = CS_CRYPT("profiled macro"); const uint32_t macro_line = __LINE__;
+    const auto wide = CS_CRYPT(L"profiled wide"); const uint32_t wide_line = __LINE__;
+
+    for ( int i = 0; 3 > i; ++i ) {
+        global.decrypt();
+    }
+    char buffer[32];
+    local.decrypt_into(buffer, sizeof(buffer));
+    local.decrypt_range(0, 4, buffer);
+    std::ostringstream stream;
+    macro.decrypt_to(stream);
+    macro.decrypt_static();
+    wide.decrypt();
+
+    const std::vector<cs::profile_entry> sites = cs::profile_sites();
+    expect(sites.size() == 4, "one entry per site");
+    const cs::profile_entry* entry = find_site(sites, global_line);
+    expect(entry && entry->calls == 3, "cs::crypt at namespace scope reports the caller's line");
+    entry = find_site(sites, local_line);
+    expect(entry && entry->calls == 2, "cs::crypt in a function reports the caller's line");
+    entry = find_site(sites, macro_line);
+    expect(entry && entry->calls == 2, "CS_CRYPT reports the line of the macro");
+    entry = find_site(sites, wide_line);
+    expect(entry && entry->calls == 1, "wide CS_CRYPT reports the line of the macro");
+    for ( const cs::profile_entry& site : sites ) {
+        expect(std::strcmp(site.file, __FILE__) == 0, "all sites are in this file");
+        expect(site.label != 0, "sites carry a label");
+    }
+    expect(cs::profile_sites(2).size() == 2, "top sites");
+    return test::result();
+}
@@ -0,0 +1,83 @@
+#include <cryptstr.hpp>
+#include <stdexcept>
+#include <string>
+#include "expect.hpp"
+
+/* decrypt_range and crypt_cursor
+    partial decrypts match the plaintext at any offset and across the 64 element windows of the cursor,
+    and ranges or positions beyond the string throw std::out_of_range.
+*/
+
+using test::expect;
+
+#define CS_TEST_64 "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-_"
+
+template < class Fn >
+bool throws_out_of_range( Fn&& _fn ) {
+    try {
+        _fn();
+    } catch ( const std::out_of_range& ) {
+        return true;
+    }
+    return false;
+}
+
+template < class Crypted >
+void check( const Crypted& _crypted ) {
+    const std::string plain = CS_TEST_64 CS_TEST_64 "tail";
+    const size_t len = _crypted.size();
+    expect(len == plain.size() + 1, "size includes the terminator");
+
+    // decrypt_range at offsets and counts around the window size
+    char out[256];
+    const size_t offsets[] = { 0, 1, 63, 64, 65, 127, 128, 131, 132 };
+    for ( size_t offset : offsets ) {
+        for ( size_t count = 0; len - offset >= count; count += 7 ) {
+            expect(_crypted.decrypt_range(offset, count, out) == count, "decrypt_range count");
+            expect(plain.compare(offset, count, out, offset + count > plain.size() ? plain.size() - offset : count) == 0,
+                "decrypt_range content");
+        }
+    }
+    expect(_crypted.decrypt_range(len - 1, 1, out) == 1 && out[0] == '\0', "the terminator is in range");
+    expect(_crypted.decrypt_range(len, 0, out) == 0, "empty range at the end");
+    expect(throws_out_of_range([&] { _crypted.decrypt_range(len + 1, 0, out); }), "offset beyond the end");
+    expect(throws_out_of_range([&] { _crypted.decrypt_range(len - 1, 2, out); }), "count beyond the end");
+    expect(throws_out_of_range([&] { _crypted.decrypt_range(1, static_cast<size_t>(-1), out); }), "wrapping count");
+
+    // sequential reads across window boundaries
+    auto cursor = _crypted.cursor();
+    expect(cursor.size() == len, "cursor size");
+    std::string sequential;
+    while ( !cursor.eof() ) {
+        sequential.push_back(cursor.next());
+    }
+    expect(sequential == std::string(plain.c_str(), plain.size() + 1), "sequential cursor reads");
+    expect(throws_out_of_range([&] { cursor.peek(); }), "peek at the end");
+
+    // random access, first and last element of every window
+    for ( size_t pos : { size_t(127), size_t(0), size_t(64), size_t(63), size_t(128), size_t(1), size_t(132) } ) {
+        cursor.seek(pos);
+        expect(cursor.tell() == pos, "seek");
+        expect(cursor.peek() == plain[pos], "peek after seek");
+    }
+    cursor.seek(len);
+    expect(cursor.eof(), "seek to the end");
+    expect(throws_out_of_range([&] { cursor.seek(len + 1); }), "seek beyond the end");
+
+    // skip clamps, read stops at the end
+    cursor.seek(60);
+    cursor.skip(10);
+    expect(cursor.tell() == 70 && cursor.next() == plain[70], "skip across a window boundary");
+    cursor.skip(1000);
+    expect(cursor.eof(), "skip clamps to the end");
+    cursor.seek(120);
+    expect(cursor.read(out, 100) == len - 120, "read stops at the end");
+    expect(plain.compare(120, std::string::npos, out, plain.size() - 120) == 0, "read content");
+    expect(cursor.eof(), "read advances");
+}
+
+int main() {
+    check(cs::crypt(cs::xor_functor<0x2a>(), CS_TEST_64 CS_TEST_64 "tail"));
+    check(cs::crypt(cs::chacha_keystream(17), CS_TEST_64 CS_TEST_64 "tail"));
+    return test::result();
+}
@@ -0,0 +1,50 @@
+#!/bin/sh
+# builds and runs every tests/*.cpp at -O0 and -O2.
+# A test may list literals that must not appear in its binary with lines of the form
+#     // must-not-leak: LITERAL
+# which are checked with strings(1) after the build. Lines of the form
+#     // variant: FLAG
+# build and run the test once more with the compiler flag FLAG added.
+#
+# usage: tests/run_tests.sh [CXX flags...], CXX selects the compiler (default g++)
+
+CXX=${CXX:-g++}
+root=$(cd "$(dirname "$0")/.." && pwd)
+out=$(mktemp -d)
+trap 'rm -rf "$out"' EXIT
+failed=0
+
+for test in "$root"/tests/*.cpp; do
+    name=$(basename "$test" .cpp)
+    for opt in -O0 -O2; do
+        for variant in "" $(sed -n 's#^// variant: ##p' "$test"); do
+            label="$name $opt${variant:+ $variant}"
+            bin="$out/bin"
+            if ! $CXX -std=c++17 $opt -Wall -Wextra -pthread -I"$root/src" $variant "$@" "$test" -o "$bin"; then
+                echo "FAIL $label: build"
+                failed=1
+                continue
+            fi
+            if ! "$bin" > "$out/log" 2>&1; then
+                echo "FAIL $label: run"
+                cat "$out/log"
+                failed=1
+                continue
+            fi
+            leaked=0
+            for literal in $(sed -n 's#^// must-not-leak: ##p' "$test"); do
+                if strings "$bin" | grep -q "$literal"; then
+                    echo "FAIL $label: plaintext \"$literal\" found in binary"
+                    leaked=1
+                fi
+            done
+            if [ $leaked -ne 0 ]; then
+                failed=1
+                continue
+            fi
+            echo "ok   $label"
+        done
+    done
+done
+
+exit $failed
@@ -0,0 +1,88 @@
+#define CS_ENABLE_STATS
+#include <cryptstr.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+/* CS_ENABLE_STATS
+    counts of all threads add up exactly, including wipes of thread_local objects that are destroyed
+    after the thread released its record while other threads claim released records, and of threads
+    that could not allocate a record.
+*/
+
+// fails all allocations while set, like an exhausted heap would
+static bool fail_allocations = false;
+
+void* operator new( std::size_t _size ) {
+    void* ptr = fail_allocations ? nullptr : std::malloc(_size ? _size : 1);
+    if ( !ptr )
+        throw std::bad_alloc();
+    return ptr;
+}
+void* operator new( std::size_t _size, const std::nothrow_t& ) noexcept {
+    return fail_allocations ? nullptr : std::malloc(_size ? _size : 1);
+}
+void operator delete( void* _ptr ) noexcept {
+    std::free(_ptr);
+}
+void operator delete( void* _ptr, std::size_t ) noexcept {
+    std::free(_ptr);
+}
+
+// wipes its buffer on destruction, constructed before the thread's first count, so destroyed after its record
+struct late_wipe {
+    unsigned char buffer[16] = {};
+    ~late_wipe() {
+        cs::memzero(buffer, sizeof(buffer));
+    }
+};
+thread_local late_wipe late;
+
+int main() {
+    const size_t threads = 8;
+    const size_t rounds = 50;
+    const size_t wipes = 100;
+    // the main thread counts first, before any record exists, and cannot allocate one
+    fail_allocations = true;
+    unsigned char first[8] = {};
+    cs::memzero(first, sizeof(first));
+    fail_allocations = false;
+    const cs::stats_snapshot initial = cs::stats();
+    if ( initial.wipe_calls != 1 || initial.wipe_bytes != sizeof(first) ) {
+        std::printf("wipe without a record not counted\n");
+        return 1;
+    }
+
+    const cs::stats_snapshot before = cs::stats();
+
+    for ( size_t round = 0; rounds > round; ++round ) {
+        std::vector<std::thread> pool;
+        for ( size_t t = 0; threads > t; ++t ) {
+            pool.emplace_back([&] {
+                late.buffer[0] = 1;
+                unsigned char buffer[32];
+                for ( size_t i = 0; wipes > i; ++i ) {
+                    cs::memzero(buffer, sizeof(buffer));
+                }
+            });
+        }
+        for ( std::thread& thread : pool ) {
+            thread.join();
+        }
+    }
+
+    const cs::stats_snapshot after = cs::stats();
+    const uint64_t calls = after.wipe_calls - before.wipe_calls;
+    const uint64_t bytes = after.wipe_bytes - before.wipe_bytes;
+    const uint64_t expected_calls = rounds * threads * (wipes + 1);
+    const uint64_t expected_bytes = rounds * threads * (wipes * 32 + 16);
+    if ( calls != expected_calls || bytes != expected_bytes ) {
+        std::printf("wipes: %llu calls, %llu bytes, expected %llu calls, %llu bytes\n",
+            static_cast<unsigned long long>(calls), static_cast<unsigned long long>(bytes),
+            static_cast<unsigned long long>(expected_calls), static_cast<unsigned long long>(expected_bytes));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <cryptstr_table.hpp>
+#include <cstdio>
+#include <cstring>
+#include "expect.hpp"
+
+/* crypt_table
+    large tables with keystream functors are encrypted block-wise within the default constexpr limits,
+    and every string decrypts back to its literal. decrypt() returns it terminated like cryptstr::decrypt().
+*/
+// must-not-leak: TableEntryAlpha
+// must-not-leak: TableEntryOmega
+
+#define CS_TEST_64 "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-_"
+#define CS_TEST_1K CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 \
+    CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64 CS_TEST_64
+#define CS_TEST_8K CS_TEST_1K CS_TEST_1K CS_TEST_1K CS_TEST_1K CS_TEST_1K CS_TEST_1K CS_TEST_1K CS_TEST_1K
+
+static constexpr auto table = cs::make_table(cs::chacha_keystream(7), "TableEntryAlpha",
+    CS_TEST_8K, CS_TEST_8K, CS_TEST_8K, CS_TEST_8K, "", "TableEntryOmega");
+static_assert(table.size() == 7, "seven strings");
+static_assert(table.total_size == 4 * 8192 + 30, "strings are packed without terminators");
+
+int main() {
+    int failed = 0;
+    static char buffer[8192];
+    const char block[] = CS_TEST_64;
+    for ( size_t s = 1; 5 > s; ++s ) {
+        const size_t len = table.decrypt_into(table[s], buffer, sizeof(buffer));
+        if ( len != 8192 )
+            failed = 1;
+        for ( size_t i = 0; len > i; ++i ) {
+            if ( buffer[i] != block[i % 64] )
+                failed = 1;
+        }
+    }
+    if ( table.decrypt_into(table[5], buffer, sizeof(buffer)) != 0 )
+        failed = 1;
+
+    char expected[32];
+    test::join(expected, "TableEntry", "Alpha");
+    size_t len = table.decrypt_into(table[0], buffer, sizeof(buffer));
+    if ( len != std::strlen(expected) || std::memcmp(buffer, expected, len) != 0 )
+        failed = 1;
+    test::join(expected, "TableEntry", "Omega");
+    len = table.decrypt_into(table[6], buffer, sizeof(buffer));
+    if ( len != std::strlen(expected) || std::memcmp(buffer, expected, len) != 0 )
+        failed = 1;
+
+    // decrypt() appends the terminator the table does not store, like cryptstr::decrypt()
+    const auto view = table.decrypt(table[6]);
+    if ( view.size() != len + 1 || view[len] != '\0' || std::strcmp(view.c_str(), expected) != 0 )
+        failed = 1;
+    const auto empty = table.decrypt(table[5]);
+    if ( empty.size() != 1 || empty[0] != '\0' )
+        failed = 1;
+    if ( failed )
+        std::printf("decrypted table does not match\n");
+    return failed;
+}
@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cryptstr.hpp>
+
+/* build-time encryption of binary resources
+    encrypts INPUT with a keystream functor and writes a header defining the crypted bytes and a
+    constexpr cs::cryptblob NAME for them. The file is read and encrypted in chunks by the runtime
+    keystream kernels, so multi-megabyte inputs never pass through constant evaluation.
+
+    --generator selects the keystream (default chacha), --seed fixes the key for reproducible builds,
+    otherwise a random seed is drawn on every run.
+
+    usage: embed [--generator xorshift|pcg|chacha] [--seed N] [--namespace NS] NAME INPUT OUTPUT
+*/
+
+struct options {
+    std::string generator = "chacha";
+    std::string ns = "resources";
+    uint64_t seed = 0;
+    bool has_seed = false;
+    std::string name;
+    std::string input;
+    std::string output;
+};
+
+static bool is_identifier( const std::string& str ) {
+    if ( str.empty() || std::isdigit(static_cast<unsigned char>(str[0])) )
+        return false;
+    for ( char c : str ) {
+        if ( !std::isalnum(static_cast<unsigned char>(c)) && c != '_' )
+            return false;
+    }
+    return true;
+}
+
+// encrypts in to out chunk by chunk, writes the bytes as initializer list
+// \return number of encrypted bytes or -1 on read errors
+template < class Keystream >
+static long long encrypt( const Keystream& keystream, std::FILE* in, std::FILE* out ) {
+    std::vector<unsigned char> plain(1 << 16);
+    std::vector<unsigned char> crypted(plain.size());
+    long long total = 0;
+    size_t num;
+    while ( (num = std::fread(plain.data(), 1, plain.size(), in)) > 0 ) {
+        keystream.apply_block(plain.data(), crypted.data(), static_cast<size_t>(total), num);
+        for ( size_t i = 0; num > i; ++i ) {
+            std::fprintf(out, ( (total + static_cast<long long>(i)) % 20 == 19 ) ? "%u,\n" : "%u,",
+                         static_cast<unsigned>(crypted[i]));
+        }
+        total += static_cast<long long>(num);
+    }
+    cs::memzero(plain.data(), plain.size());
+    return std::ferror(in) ? -1 : total;
+}
+
+template < class Keystream >
+static bool generate( const options& opt, const char* type ) {
+    std::FILE* in = std::fopen(opt.input.c_str(), "rb");
+    if ( !in ) {
+        std::fprintf(stderr, "embed: cannot open %s\n", opt.input.c_str());
+        return false;
+    }
+    const std::string temporary = opt.output + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "w");
+    if ( !out ) {
+        std::fprintf(stderr, "embed: cannot create %s\n", temporary.c_str());
+        std::fclose(in);
+        return false;
+    }
+
+    std::fprintf(out, "// generated by embed from %s, do not edit\n#pragma once\n\n#include <cryptstr_blob.hpp>\n\n"
+                      "namespace %s {\n\nalignas(64) inline constexpr unsigned char %s_data[] = {\n",
+                 opt.input.c_str(), opt.ns.c_str(), opt.name.c_str());
+    const long long size = encrypt(Keystream(opt.seed), in, out);
+    // zero-sized arrays are invalid, empty inputs get one unused byte
+    if ( size == 0 )
+        std::fprintf(out, "0");
+    std::fprintf(out, "\n};\ninline constexpr cs::cryptblob<%s> %s(%s(UINT64_C(0x%016llx)), %s_data, %lld);\n\n}\n",
+                 type, opt.name.c_str(), type, static_cast<unsigned long long>(opt.seed), opt.name.c_str(), size);
+
+    std::fclose(in);
+    const bool ok = size >= 0 && std::fclose(out) == 0;
+    if ( !ok || std::rename(temporary.c_str(), opt.output.c_str()) != 0 ) {
+        std::fprintf(stderr, "embed: cannot write %s\n", opt.output.c_str());
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    options opt;
+    std::vector<std::string> positional;
+    for ( int i = 1; argc > i; ++i ) {
+        const bool has_value = argc > i + 1;
+        if ( std::strcmp(argv[i], "--generator") == 0 && has_value ) {
+            opt.generator = argv[++i];
+        } else if ( std::strcmp(argv[i], "--seed") == 0 && has_value ) {
+            opt.seed = std::strtoull(argv[++i], nullptr, 0);
+            opt.has_seed = true;
+        } else if ( std::strcmp(argv[i], "--namespace") == 0 && has_value ) {
+            opt.ns = argv[++i];
+        } else if ( argv[i][0] != '-' ) {
+            positional.push_back(argv[i]);
+        } else {
+            positional.clear();
+            break;
+        }
+    }
+    if ( positional.size() != 3 || !is_identifier(positional[0]) || !is_identifier(opt.ns) ) {
+        std::fprintf(stderr, "usage: %s [--generator xorshift|pcg|chacha] [--seed N] [--namespace NS] NAME INPUT OUTPUT\n", argv[0]);
+        return 1;
+    }
+    opt.name = positional[0];
+    opt.input = positional[1];
+    opt.output = positional[2];
+    if ( !opt.has_seed ) {
+        std::random_device device;
+        opt.seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+    }
+
+    bool ok = false;
+    if ( opt.generator == "xorshift" ) {
+        ok = generate<cs::xorshift_keystream>(opt, "cs::xorshift_keystream");
+    } else if ( opt.generator == "pcg" ) {
+        ok = generate<cs::pcg_keystream>(opt, "cs::pcg_keystream");
+    } else if ( opt.generator == "chacha" ) {
+        ok = generate<cs::chacha_keystream>(opt, "cs::chacha_keystream");
+    } else {
+        std::fprintf(stderr, "embed: unknown generator %s\n", opt.generator.c_str());
+    }
+    return ok ? 0 : 1;
+}
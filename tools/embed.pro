@@ -0,0 +1,17 @@
+# conf
+CONFIG -= qt
+CONFIG += c++17 release
+
+# inputs
+HEADERS += \
+    ../src/cryptstr.hpp \
+    ../src/cryptstr_blob.hpp
+SOURCES += \
+        embed.cpp
+
+INCLUDEPATH += ../src/
+
+# outputs
+DESTDIR = .
+OBJECTS_DIR = obj/
+TARGET = embed